@@ -0,0 +1,77 @@
+/*
+ * File:   AreaEventStream.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Collects the enter / leave transitions of entities in areas, to be sent as
+// toaster_msgs::AreaEvent. Transitions may be reported from several threads.
+// With a debounce time, a pair (entity, area) sends at most one event per
+// debounce time: later transitions are held and only sent if the entity did
+// not come back to its previous state in the meantime.
+// The debounce runs on the clock given by setNow, the events keep the times
+// of the entities.
+
+#ifndef AREAEVENTSTREAM_H
+#define	AREAEVENTSTREAM_H
+
+#include "toaster-lib/Area.h"
+#include "toaster-lib/Entity.h"
+#include <toaster_msgs/AreaEvent.h>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+class AreaEventStream {
+public:
+    AreaEventStream();
+
+    // Debounce time in ns, 0 to send every transition
+    void setDebounce(unsigned long debounce) {debounce_ = debounce; }
+
+    // Time in ns of the next transitions, and of the release of the held ones
+    void setNow(unsigned long now) {now_ = now; }
+
+    void transition(Entity* ent, Area* area, bool enter);
+
+    // Forgets the pairs of a removed area, without sending events
+    void removeArea(unsigned int areaId);
+
+    // Forgets the pairs of the entities which are not in entities
+    void keepEntities(const std::vector<std::pair<std::string, Entity*> >& entities);
+
+    // Gives the events to send, ordered by entity then area.
+    void takeEvents(std::vector<toaster_msgs::AreaEvent>& events);
+
+private:
+    struct pairState_t {
+        std::string entityName;
+        std::string areaName;
+
+        bool sent;
+        bool sentInside;        // last state sent
+        unsigned long sentClock;
+        unsigned long enterTime;
+
+        // transition waiting the end of the debounce time
+        bool heldInside;
+        unsigned long heldTime;
+    };
+
+    typedef std::pair<std::string, unsigned int> pairKey_t;
+
+    void addEvent(const pairKey_t& key, pairState_t& state, bool enter, unsigned long time);
+    bool debounced(const pairState_t& state) const;
+
+    unsigned long debounce_;
+    unsigned long now_;
+    std::mutex mutex_;
+    std::map<pairKey_t, pairState_t> pairs_;
+    std::set<pairKey_t> heldPairs_;
+    std::vector<toaster_msgs::AreaEvent> events_;
+    std::vector<std::string> keptIds_;
+};
+
+#endif	/* AREAEVENTSTREAM_H */
@@ -0,0 +1,58 @@
+/*
+ * File:   AreaIndex.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Spatial index over the 2D bounding boxes of the areas.
+// It is used to test an entity only against the areas that may contain it
+// instead of going through the whole area map.
+
+#ifndef AREAINDEX_H
+#define	AREAINDEX_H
+
+#include "toaster-lib/CircleArea.h"
+#include "toaster-lib/PolygonArea.h"
+#include <boost/geometry/index/rtree.hpp>
+#include <map>
+#include <vector>
+
+namespace bgi = boost::geometry::index;
+
+class AreaIndex {
+public:
+    typedef bg::model::d2::point_xy<double> point_t;
+    typedef bg::model::box<point_t> box_t;
+
+    AreaIndex();
+
+    // Adds an area, or refreshes it if already indexed.
+    // margin enlarges the box so that hysteresis is still covered.
+    void insert(Area* area, double margin);
+    void remove(unsigned int id);
+    void clear();
+
+    // To call when an area geometry changed (owner moved).
+    void update(unsigned int id);
+
+    // Fills ids with the areas whose box contains position.
+    void query(const bg::model::point<double, 3, bg::cs::cartesian>& position, std::vector<unsigned int>& ids) const;
+
+    unsigned int size() const;
+
+private:
+    typedef std::pair<box_t, unsigned int> value_t;
+
+    struct indexed_t {
+        Area* area;
+        double margin;
+        box_t box;
+    };
+
+    box_t computeBox(Area* area, double margin) const;
+
+    bgi::rtree<value_t, bgi::quadratic<16> > rtree_;
+    std::map<unsigned int, indexed_t> indexed_;
+};
+
+#endif	/* AREAINDEX_H */
@@ -0,0 +1,83 @@
+/*
+ * File:   AreaRule.h
+ *
+ * Created on October 19, 2026
+ */
+
+// An area rule is the resolved form of the strings carried by an area
+// (factType, areaType, entityType and owner). It is built once when the area is
+// added so that fact computation does not compare strings for each entity.
+// To add a new fact kind: add it to areaFactType_t, parse it in makeAreaRule
+// and give its functions in the factRules_ table of AreaRule.cpp.
+
+#ifndef AREARULE_H
+#define	AREARULE_H
+
+#include "toaster-lib/Area.h"
+#include "toaster-lib/Entity.h"
+#include <toaster_msgs/FactList.h>
+#include <string>
+
+enum areaFactType_t {
+    NO_FACT = 0,
+    INTERACTION_FACT,
+    DENSITY_FACT,
+    UNKNOWN_FACT,
+    NB_FACT_TYPES
+};
+
+enum areaType_t {
+    ROOM_AREA = 0,
+    SUPPORT_AREA,
+    OTHER_AREA
+};
+
+struct areaRule_t {
+    areaFactType_t factType;
+    areaType_t areaType;
+
+    // Entity types concerned by the area
+    bool humans;
+    bool robots;
+    bool objects;
+
+    // Owner is resolved once it is seen by a reader
+    std::string ownerId;
+    Entity* owner;
+
+    // Entities inside the area, updated on enter / leave transitions
+    unsigned int insideHumans;
+    unsigned int insideRobots;
+    unsigned int insideObjects;
+    unsigned long transitionTime;
+
+    // Last density fact, recomputed only when the counts changed
+    bool densityChanged;
+    int densityPopulation;
+    toaster_msgs::Fact densityFact;
+};
+
+// Number of entities known by the readers, used for ratios
+struct population_t {
+    unsigned int humans;
+    unsigned int robots;
+    unsigned int objects;
+};
+
+areaRule_t makeAreaRule(Area* area);
+
+bool areaCompatible(const areaRule_t& rule, EntityType entType);
+
+void setAreaOwner(areaRule_t& rule, Entity* owner);
+
+// Occupancy update, to call when an entity enters or leaves the area
+void enterAreaRule(areaRule_t& rule, Entity* ent);
+void leaveAreaRule(areaRule_t& rule, Entity* ent);
+
+// Fact computed for an entity inside the area
+void computeEntityFacts(Entity* ent, const std::string& subjectId, Area* area, areaRule_t& rule, toaster_msgs::FactList& factList);
+
+// Fact computed once for the area, after all its entities
+void computeAreaFacts(Area* area, areaRule_t& rule, const population_t& population, toaster_msgs::FactList& factList);
+
+#endif	/* AREARULE_H */
@@ -0,0 +1,67 @@
+/*
+ * File:   AreaVolume.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Volume of a polygon area, extruded between its zmin and zmax.
+// A convex polygon is kept as a set of half-planes: a point is inside if it is
+// behind every plane, which is a plain loop over contiguous arrays.
+// Non convex polygons fall back to boost::geometry.
+// An oriented box is a volume built from a rectangle, see boxCorners.
+
+#ifndef AREAVOLUME_H
+#define	AREAVOLUME_H
+
+#include "toaster-lib/PolygonArea.h"
+#include <vector>
+
+// Box description, kept to publish the area as it was given
+struct areaBox_t {
+    double center[3];
+    double size[3];
+    double yaw;
+};
+
+class AreaVolume {
+public:
+    AreaVolume();
+
+    // Builds the volume from the current polygon and z bounds of the area.
+    // To call again when the area moved.
+    void build(PolygonArea* area);
+
+    // Distance to the volume boundary, negative inside.
+    // Outside a convex volume, it is the largest distance to a plane, which is
+    // less than the euclidean distance near corners.
+    double distance(const bg::model::point<double, 3, bg::cs::cartesian>& point) const;
+
+    // An entity outside has to be deeper than enterHysteresis to enter,
+    // an entity inside can go as far as leaveHysteresis before leaving.
+    bool contains(const bg::model::point<double, 3, bg::cs::cartesian>& point, bool wasInside) const;
+
+    bool isConvex() const {return convex_; }
+
+    // Corners of a box of size x size y rotated by yaw around center, counter clockwise
+    static void boxCorners(const areaBox_t& box, double corners[4][2]);
+
+    double enterHysteresis;
+    double leaveHysteresis;
+
+    bool isBox;
+    areaBox_t box;
+
+private:
+    // Half-planes nx * x + ny * y <= d, with outward unit normals
+    std::vector<double> nx_;
+    std::vector<double> ny_;
+    std::vector<double> d_;
+
+    double zmin_;
+    double zmax_;
+    bool convex_;
+
+    bg::model::polygon<bg::model::d2::point_xy<double> > poly_;
+};
+
+#endif	/* AREAVOLUME_H */
@@ -0,0 +1,46 @@
+/*
+ * File:   WorkerPool.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Fixed set of threads running the same job, each with its own worker index.
+// run() blocks until every worker finished, so data prepared before the call
+// can be read without locking and results gathered after it.
+
+#ifndef WORKERPOOL_H
+#define	WORKERPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+public:
+    WorkerPool(unsigned int nbWorkers);
+    WorkerPool(const WorkerPool&) = delete;
+    ~WorkerPool();
+
+    unsigned int size() const {return nbWorkers_; }
+
+    // Calls job(worker) once for each worker in [0, size())
+    void run(const std::function<void(unsigned int)>& job);
+
+private:
+    void loop(unsigned int worker);
+
+    unsigned int nbWorkers_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    std::condition_variable done_;
+    std::function<void(unsigned int)> job_;
+    unsigned long generation_;
+    unsigned int pending_;
+    bool stop_;
+};
+
+#endif	/* WORKERPOOL_H */
@@ -0,0 +1,135 @@
+/*
+ * File:   AreaEventStream.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "area_manager/AreaEventStream.h"
+#include <algorithm>
+
+bool eventOrder(const toaster_msgs::AreaEvent& a, const toaster_msgs::AreaEvent& b) {
+    if (a.entityId != b.entityId)
+        return a.entityId < b.entityId;
+    if (a.areaId != b.areaId)
+        return a.areaId < b.areaId;
+    return a.time < b.time;
+}
+
+AreaEventStream::AreaEventStream() {
+    debounce_ = 0;
+    now_ = 0;
+}
+
+// A clock going back, as when a replay starts again, ends the debounce time
+bool AreaEventStream::debounced(const pairState_t& state) const {
+    return debounce_ == 0 || !state.sent || now_ < state.sentClock || now_ - state.sentClock >= debounce_;
+}
+
+void AreaEventStream::transition(Entity* ent, Area* area, bool enter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    pairKey_t key(ent->getId(), area->getId());
+    std::map<pairKey_t, pairState_t>::iterator it = pairs_.find(key);
+    if (it == pairs_.end()) {
+        pairState_t newState;
+        newState.entityName = ent->getName();
+        newState.areaName = area->getName();
+        newState.sent = false;
+        newState.sentInside = false;
+        newState.sentClock = 0;
+        newState.enterTime = 0;
+        newState.heldInside = false;
+        newState.heldTime = 0;
+        it = pairs_.insert(std::make_pair(key, newState)).first;
+    }
+
+    pairState_t& state = it->second;
+    unsigned long time = ent->getTime();
+
+    if (debounced(state)) {
+        heldPairs_.erase(key);
+        if (state.sentInside != enter)
+            addEvent(key, state, enter, time);
+    } else {
+        state.heldInside = enter;
+        state.heldTime = time;
+        heldPairs_.insert(key);
+    }
+}
+
+void AreaEventStream::removeArea(unsigned int areaId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (std::map<pairKey_t, pairState_t>::iterator it = pairs_.begin(); it != pairs_.end();) {
+        if (it->first.second == areaId) {
+            heldPairs_.erase(it->first);
+            pairs_.erase(it++);
+        } else
+            ++it;
+    }
+}
+
+void AreaEventStream::keepEntities(const std::vector<std::pair<std::string, Entity*> >& entities) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pairs_.empty())
+        return;
+
+    keptIds_.clear();
+    for (unsigned int i = 0; i < entities.size(); ++i)
+        keptIds_.push_back(entities[i].second->getId());
+    std::sort(keptIds_.begin(), keptIds_.end());
+
+    // Both are sorted by entity id
+    std::vector<std::string>::const_iterator itId = keptIds_.begin();
+    for (std::map<pairKey_t, pairState_t>::iterator it = pairs_.begin(); it != pairs_.end();) {
+        while (itId != keptIds_.end() && *itId < it->first.first)
+            ++itId;
+        if (itId == keptIds_.end() || *itId != it->first.first) {
+            heldPairs_.erase(it->first);
+            pairs_.erase(it++);
+        } else
+            ++it;
+    }
+}
+
+void AreaEventStream::takeEvents(std::vector<toaster_msgs::AreaEvent>& events) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Held transitions are sent if the entity is still in the new state
+    for (std::set<pairKey_t>::iterator it = heldPairs_.begin(); it != heldPairs_.end();) {
+        pairState_t& state = pairs_[*it];
+        if (debounced(state)) {
+            if (state.heldInside != state.sentInside)
+                addEvent(*it, state, state.heldInside, state.heldTime);
+            heldPairs_.erase(it++);
+        } else
+            ++it;
+    }
+
+    std::sort(events_.begin(), events_.end(), eventOrder);
+    events.swap(events_);
+    events_.clear();
+}
+
+void AreaEventStream::addEvent(const pairKey_t& key, pairState_t& state, bool enter, unsigned long time) {
+    toaster_msgs::AreaEvent event;
+    event.entityId = key.first;
+    event.entityName = state.entityName;
+    event.areaId = key.second;
+    event.areaName = state.areaName;
+    event.time = time;
+
+    if (enter) {
+        event.transition = toaster_msgs::AreaEvent::ENTER;
+        event.dwellTime = 0.0;
+        state.enterTime = time;
+    } else {
+        event.transition = toaster_msgs::AreaEvent::LEAVE;
+        event.dwellTime = time > state.enterTime ? (time - state.enterTime) / 1e9 : 0.0;
+    }
+
+    state.sent = true;
+    state.sentInside = enter;
+    state.sentClock = now_;
+    events_.push_back(event);
+}
@@ -0,0 +1,79 @@
+/*
+ * File:   AreaIndex.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "area_manager/AreaIndex.h"
+
+AreaIndex::AreaIndex() {
+}
+
+AreaIndex::box_t AreaIndex::computeBox(Area* area, double margin) const {
+    box_t box;
+    if (area->getIsCircle()) {
+        CircleArea* circle = (CircleArea*) area;
+        double ray = circle->getRay() + margin;
+        box.min_corner() = point_t(circle->getCenter().get<0>() - ray, circle->getCenter().get<1>() - ray);
+        box.max_corner() = point_t(circle->getCenter().get<0>() + ray, circle->getCenter().get<1>() + ray);
+    } else {
+        bg::envelope(((PolygonArea*) area)->poly_, box);
+        box.min_corner() = point_t(box.min_corner().x() - margin, box.min_corner().y() - margin);
+        box.max_corner() = point_t(box.max_corner().x() + margin, box.max_corner().y() + margin);
+    }
+    return box;
+}
+
+void AreaIndex::insert(Area* area, double margin) {
+    remove(area->getId());
+
+    indexed_t entry;
+    entry.area = area;
+    entry.margin = margin > 0.0 ? margin : 0.0;
+    entry.box = computeBox(area, entry.margin);
+
+    indexed_[area->getId()] = entry;
+    rtree_.insert(std::make_pair(entry.box, area->getId()));
+}
+
+void AreaIndex::remove(unsigned int id) {
+    std::map<unsigned int, indexed_t>::iterator it = indexed_.find(id);
+    if (it == indexed_.end())
+        return;
+
+    rtree_.remove(std::make_pair(it->second.box, id));
+    indexed_.erase(it);
+}
+
+void AreaIndex::clear() {
+    rtree_.clear();
+    indexed_.clear();
+}
+
+void AreaIndex::update(unsigned int id) {
+    std::map<unsigned int, indexed_t>::iterator it = indexed_.find(id);
+    if (it == indexed_.end())
+        return;
+
+    box_t newBox = computeBox(it->second.area, it->second.margin);
+    if (bg::equals(newBox, it->second.box))
+        return;
+
+    rtree_.remove(std::make_pair(it->second.box, id));
+    it->second.box = newBox;
+    rtree_.insert(std::make_pair(newBox, id));
+}
+
+void AreaIndex::query(const bg::model::point<double, 3, bg::cs::cartesian>& position, std::vector<unsigned int>& ids) const {
+    std::vector<value_t> found;
+    point_t point(position.get<0>(), position.get<1>());
+    rtree_.query(bgi::intersects(point), std::back_inserter(found));
+
+    ids.clear();
+    for (unsigned int i = 0; i < found.size(); ++i)
+        ids.push_back(found[i].second);
+}
+
+unsigned int AreaIndex::size() const {
+    return indexed_.size();
+}
@@ -0,0 +1,244 @@
+/*
+ * File:   AreaRule.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "area_manager/AreaRule.h"
+#include "toaster-lib/MathFunctions.h"
+
+typedef void (*entityFact_t)(Entity* ent, const std::string& subjectId, Area* area, areaRule_t& rule, toaster_msgs::FactList& factList);
+typedef void (*areaFact_t)(Area* area, areaRule_t& rule, const population_t& population, toaster_msgs::FactList& factList);
+
+struct factRule_t {
+    entityFact_t entityFact;
+    areaFact_t areaFact;
+};
+
+// Return confidence: 0.0 if not facing 1.0 if facing
+
+double isFacing(Entity* entFacing, Entity* entSubject, double angleThreshold, double& angleResult) {
+    return MathFunctions::isInAngle(entFacing, entSubject, entFacing->getOrientation()[2], angleThreshold, angleResult);
+}
+
+//////////////////////
+// Interaction area //
+//////////////////////
+
+void interactionEntityFacts(Entity* ent, const std::string& subjectId, Area* area, areaRule_t& rule, toaster_msgs::FactList& factList) {
+    // If it is an interacting area, we need the owner!
+    if (rule.owner == NULL)
+        return;
+
+    // Now let's compute isFacing
+    //////////////////////////////
+
+    // This is the actual angle between subject orientation
+    // and target. It gives left / right relation
+    // If positive, target is at right!
+    double angleResult = 0.0;
+    double confidence = isFacing(ent, rule.owner, 0.5, angleResult);
+    if (confidence > 0.0) {
+        //Fact Facing
+        toaster_msgs::Fact fact_msg;
+        fact_msg.property = "IsFacing";
+        fact_msg.propertyType = "posture";
+        fact_msg.subProperty = "angle";
+        fact_msg.subjectId = subjectId;
+        fact_msg.targetId = rule.owner->getId();
+        fact_msg.confidence = confidence;
+        fact_msg.stringValue = "true";
+        fact_msg.doubleValue = angleResult;
+        fact_msg.valueType = 0;
+        fact_msg.factObservability = 0.5;
+        fact_msg.time = ent->getTime();
+
+        factList.factList.push_back(fact_msg);
+    }
+
+    // Compute here other facts linked to interaction
+    //////////////////////////////////////////////////
+
+    // TODO
+}
+
+//////////////////
+// Density area //
+//////////////////
+
+// The group tracker publishes its centroid as a human, which is not part of the population
+static const int densityPopulationOffset_ = -1;
+
+void densityAreaFacts(Area* area, areaRule_t& rule, const population_t& population, toaster_msgs::FactList& factList) {
+    int fullPopulation = densityPopulationOffset_;
+    if (rule.humans)
+        fullPopulation += population.humans;
+    if (rule.robots)
+        fullPopulation += population.robots;
+    if (rule.objects)
+        fullPopulation += population.objects;
+
+    // Nothing changed since last computation
+    if (!rule.densityChanged && fullPopulation == rule.densityPopulation) {
+        factList.factList.push_back(rule.densityFact);
+        return;
+    }
+
+    double areaDensity = 0.0;
+    if (fullPopulation != 0)
+        areaDensity = (double) (rule.insideHumans + rule.insideRobots + rule.insideObjects) / fullPopulation;
+
+    //Fact Density
+    toaster_msgs::Fact& fact_msg = rule.densityFact;
+    if (rule.owner != NULL)
+        fact_msg.subjectOwnerId = rule.owner->getId();
+
+    fact_msg.property = "AreaDensity";
+    fact_msg.propertyType = "density";
+    fact_msg.subProperty = "ratio";
+    fact_msg.subjectId = std::to_string(area->getId());
+    fact_msg.targetId = "";
+    fact_msg.confidence = 1.0;
+    fact_msg.doubleValue = areaDensity;
+    fact_msg.valueType = 1;
+    fact_msg.factObservability = 0.0;
+    fact_msg.time = rule.transitionTime;
+
+    rule.densityChanged = false;
+    rule.densityPopulation = fullPopulation;
+
+    factList.factList.push_back(fact_msg);
+}
+
+// Indexed by areaFactType_t
+static const factRule_t factRules_[NB_FACT_TYPES] = {
+    /* NO_FACT */          {NULL, NULL},
+    /* INTERACTION_FACT */ {interactionEntityFacts, NULL},
+    /* DENSITY_FACT */     {NULL, densityAreaFacts},
+    /* UNKNOWN_FACT */     {NULL, NULL}
+};
+
+////////////////////
+// Rule functions //
+////////////////////
+
+areaRule_t makeAreaRule(Area* area) {
+    areaRule_t rule;
+
+    if (area->getFactType() == "")
+        rule.factType = NO_FACT;
+    else if (area->getFactType() == "interaction")
+        rule.factType = INTERACTION_FACT;
+    else if (area->getFactType() == "density")
+        rule.factType = DENSITY_FACT;
+    else {
+        printf("[area_manager][WARNING] Area %s has factType %s, which is not available\n", area->getName().c_str(), area->getFactType().c_str());
+        rule.factType = UNKNOWN_FACT;
+    }
+
+    if (area->getAreaType() == "room")
+        rule.areaType = ROOM_AREA;
+    else if (area->getAreaType() == "support")
+        rule.areaType = SUPPORT_AREA;
+    else
+        rule.areaType = OTHER_AREA;
+
+    std::string entityType = area->getEntityType();
+    rule.humans = (entityType == "humans" || entityType == "agents" || entityType == "entities");
+    rule.robots = (entityType == "robots" || entityType == "agents" || entityType == "entities");
+    rule.objects = (entityType == "objects" || entityType == "entities");
+
+    rule.ownerId = area->getMyOwner();
+    rule.owner = NULL;
+
+    rule.insideHumans = 0;
+    rule.insideRobots = 0;
+    rule.insideObjects = 0;
+    rule.transitionTime = 0;
+
+    rule.densityChanged = true;
+    rule.densityPopulation = 0;
+
+    return rule;
+}
+
+bool areaCompatible(const areaRule_t& rule, EntityType entType) {
+    if (entType == ROBOT)
+        return rule.robots;
+    else if (entType == HUMAN)
+        return rule.humans;
+    else if (entType == OBJECT)
+        return rule.objects;
+    else
+        return false;
+}
+
+void setAreaOwner(areaRule_t& rule, Entity* owner) {
+    rule.owner = owner;
+    rule.densityChanged = true;
+}
+
+void enterAreaRule(areaRule_t& rule, Entity* ent) {
+    if (ent->getEntityType() == HUMAN)
+        rule.insideHumans++;
+    else if (ent->getEntityType() == ROBOT)
+        rule.insideRobots++;
+    else if (ent->getEntityType() == OBJECT)
+        rule.insideObjects++;
+
+    rule.transitionTime = ent->getTime();
+    rule.densityChanged = true;
+}
+
+void leaveAreaRule(areaRule_t& rule, Entity* ent) {
+    if (ent->getEntityType() == HUMAN && rule.insideHumans > 0)
+        rule.insideHumans--;
+    else if (ent->getEntityType() == ROBOT && rule.insideRobots > 0)
+        rule.insideRobots--;
+    else if (ent->getEntityType() == OBJECT && rule.insideObjects > 0)
+        rule.insideObjects--;
+
+    rule.transitionTime = ent->getTime();
+    rule.densityChanged = true;
+}
+
+void computeEntityFacts(Entity* ent, const std::string& subjectId, Area* area, areaRule_t& rule, toaster_msgs::FactList& factList) {
+    if (factRules_[rule.factType].entityFact != NULL)
+        factRules_[rule.factType].entityFact(ent, subjectId, area, rule, factList);
+
+    //Fact in Area
+    toaster_msgs::Fact fact_msg;
+    fact_msg.propertyType = "position";
+    switch (rule.areaType) {
+        case ROOM_AREA:
+            fact_msg.property = "IsInRoom";
+            fact_msg.subProperty = area->getAreaType();
+            break;
+        case SUPPORT_AREA:
+            fact_msg.property = "IsAt";
+            fact_msg.subProperty = "location";
+            break;
+        default:
+            fact_msg.property = "IsInArea";
+            fact_msg.subProperty = area->getAreaType();
+            break;
+    }
+
+    if (rule.owner != NULL)
+        fact_msg.targetOwnerId = rule.owner->getId();
+
+    fact_msg.subjectId = subjectId;
+    fact_msg.targetId = area->getName();
+    fact_msg.confidence = 1;
+    fact_msg.factObservability = 0.8;
+    fact_msg.time = ent->getTime();
+    fact_msg.valueType = 0;
+    fact_msg.stringValue = "true";
+
+    factList.factList.push_back(fact_msg);
+}
+
+void computeAreaFacts(Area* area, areaRule_t& rule, const population_t& population, toaster_msgs::FactList& factList) {
+    if (factRules_[rule.factType].areaFact != NULL)
+        factRules_[rule.factType].areaFact(area, rule, population, factList);
+}
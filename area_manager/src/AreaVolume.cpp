@@ -0,0 +1,119 @@
+/*
+ * File:   AreaVolume.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "area_manager/AreaVolume.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+AreaVolume::AreaVolume() {
+    enterHysteresis = 0.0;
+    leaveHysteresis = 0.0;
+    isBox = false;
+    zmin_ = 0.0;
+    zmax_ = 0.0;
+    convex_ = false;
+}
+
+void AreaVolume::build(PolygonArea* area) {
+    const std::vector<bg::model::d2::point_xy<double> >& points = area->poly_.outer();
+    unsigned int nbPoints = points.size();
+
+    // The closing point is not an edge
+    if (nbPoints > 1 && bg::equals(points.front(), points.back()))
+        nbPoints--;
+
+    nx_.clear();
+    ny_.clear();
+    d_.clear();
+    zmin_ = area->z.get<0>();
+    zmax_ = area->z.get<1>();
+
+    // Normals are turned outward whatever the polygon winding
+    double doubleArea = 0.0;
+    for (unsigned int i = 0; i < nbPoints; ++i) {
+        unsigned int j = (i + 1) % nbPoints;
+        doubleArea += points[i].x() * points[j].y() - points[j].x() * points[i].y();
+    }
+    double orientation = doubleArea >= 0.0 ? 1.0 : -1.0;
+
+    convex_ = nbPoints >= 3;
+    for (unsigned int i = 0; i < nbPoints; ++i) {
+        unsigned int j = (i + 1) % nbPoints;
+        unsigned int k = (i + 2) % nbPoints;
+        double ex = points[j].x() - points[i].x();
+        double ey = points[j].y() - points[i].y();
+        double length = sqrt(ex * ex + ey * ey);
+        if (length < 1e-9)
+            continue;
+
+        // A reflex vertex makes the polygon non convex
+        double cross = ex * (points[k].y() - points[j].y()) - ey * (points[k].x() - points[j].x());
+        if (cross * orientation < -1e-9)
+            convex_ = false;
+
+        double nx = orientation * ey / length;
+        double ny = -orientation * ex / length;
+        nx_.push_back(nx);
+        ny_.push_back(ny);
+        d_.push_back(nx * points[i].x() + ny * points[i].y());
+    }
+
+    if (convex_)
+        poly_.clear();
+    else
+        poly_ = area->poly_;
+}
+
+double AreaVolume::distance(const bg::model::point<double, 3, bg::cs::cartesian>& point) const {
+    double x = point.get<0>();
+    double y = point.get<1>();
+    double z = point.get<2>();
+
+    double dist = std::max(zmin_ - z, z - zmax_);
+
+    if (convex_) {
+        for (unsigned int i = 0; i < d_.size(); ++i)
+            dist = std::max(dist, nx_[i] * x + ny_[i] * y - d_[i]);
+        return dist;
+    }
+
+    if (poly_.outer().size() < 3)
+        return std::numeric_limits<double>::max();
+
+    bg::model::d2::point_xy<double> point2d(x, y);
+    bg::model::linestring<bg::model::d2::point_xy<double> > boundary(poly_.outer().begin(), poly_.outer().end());
+    double dist2d = bg::distance(point2d, boundary);
+    if (bg::within(point2d, poly_))
+        dist2d = -dist2d;
+
+    return std::max(dist, dist2d);
+}
+
+bool AreaVolume::contains(const bg::model::point<double, 3, bg::cs::cartesian>& point, bool wasInside) const {
+    if (wasInside)
+        return distance(point) <= leaveHysteresis;
+    else
+        return distance(point) <= -enterHysteresis;
+}
+
+void AreaVolume::boxCorners(const areaBox_t& box, double corners[4][2]) {
+    static const double signs[4][2] = {
+        {1.0, 1.0},
+        {-1.0, 1.0},
+        {-1.0, -1.0},
+        {1.0, -1.0}
+    };
+
+    double cosYaw = cos(box.yaw);
+    double sinYaw = sin(box.yaw);
+    for (unsigned int i = 0; i < 4; ++i) {
+        double x = signs[i][0] * box.size[0] / 2.0;
+        double y = signs[i][1] * box.size[1] / 2.0;
+        corners[i][0] = box.center[0] + cosYaw * x - sinYaw * y;
+        corners[i][1] = box.center[1] + sinYaw * x + cosYaw * y;
+    }
+}
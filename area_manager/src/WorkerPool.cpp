@@ -0,0 +1,72 @@
+/*
+ * File:   WorkerPool.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "area_manager/WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned int nbWorkers) {
+    nbWorkers_ = nbWorkers > 0 ? nbWorkers : 1;
+    generation_ = 0;
+    pending_ = 0;
+    stop_ = false;
+
+    // Worker 0 is the calling thread
+    for (unsigned int i = 1; i < nbWorkers_; ++i)
+        threads_.push_back(std::thread(&WorkerPool::loop, this, i));
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wakeUp_.notify_all();
+
+    for (unsigned int i = 0; i < threads_.size(); ++i)
+        threads_[i].join();
+}
+
+void WorkerPool::run(const std::function<void(unsigned int)>& job) {
+    if (threads_.empty()) {
+        job(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = job;
+        pending_ = threads_.size();
+        generation_++;
+    }
+    wakeUp_.notify_all();
+
+    job(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] {return pending_ == 0; });
+}
+
+void WorkerPool::loop(unsigned int worker) {
+    unsigned long lastGeneration = 0;
+    while (true) {
+        std::function<void(unsigned int)> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeUp_.wait(lock, [this, lastGeneration] {return stop_ || generation_ != lastGeneration; });
+            if (stop_)
+                return;
+            lastGeneration = generation_;
+            job = job_;
+        }
+
+        job(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_--;
+        }
+        done_.notify_one();
+    }
+}
@@ -9,17 +9,27 @@
 #include "toaster_msgs/Empty.h"
 #include "toaster_msgs/GetRelativePosition.h"
 #include "toaster_msgs/GetMultiRelativePosition.h"
+#include "toaster_msgs/GetRelativePositionsMatrix.h"
 #include "toaster_msgs/Area.h"
 #include "toaster_msgs/AreaList.h"
+#include "toaster_msgs/AreaUpdate.h"
 #include "toaster-lib/CircleArea.h"
 #include "toaster-lib/PolygonArea.h"
 #include "toaster-lib/MathFunctions.h"
 #include "toaster-lib/Object.h"
 #include "toaster-lib/Entity.h"
+#include "area_manager/AreaIndex.h"
+#include "area_manager/AreaRule.h"
+#include "area_manager/WorkerPool.h"
+#include "area_manager/AreaEventStream.h"
+#include "area_manager/AreaVolume.h"
 #include <toaster_msgs/Fact.h>
 #include <toaster_msgs/FactList.h>
 #include <geometry_msgs/PolygonStamped.h>
 #include <iterator>
+#include <algorithm>
+#include <set>
+#include <mutex>
 //#include <boost/numeric/ublas/matrix.hpp>
 //#include <boost/numeric/ublas/io.hpp>
 
@@ -34,15 +44,44 @@ typedef bg::model::point<double, 3, bg::cs::cartesian> point_type3d;
 std::map<unsigned int, Area*> mapArea_;
 std::map<std::string, Entity*> mapEntities_;
 
+// Bounding boxes of mapArea_, to find candidate areas of an entity
+AreaIndex areaIndex_;
+
+// Resolved types and owner of each area of mapArea_
+std::map<unsigned int, areaRule_t> mapAreaRule_;
+
+// Volumetric areas, tested with their volume instead of the toaster-lib test
+std::map<unsigned int, AreaVolume> mapAreaVolume_;
+
+// Areas attached to each owner, and owner pose at their last update
+struct ownerPose_t {
+    double x;
+    double y;
+    double z;
+    double theta;
+};
+std::map<std::string, std::vector<unsigned int> > mapOwnerAreas_;
+std::map<unsigned int, ownerPose_t> mapOwnerPose_;
+
+// Owned areas are moved only if the owner moved more than this (m or rad)
+double ownerMoveThreshold_ = 0.001;
+
 // Publisher for area
 bool publishingArea_ = true;
 
+// Area messages are only rebuilt and published when an area changes
+std::map<unsigned int, unsigned int> mapAreaVersion_;
+std::map<unsigned int, toaster_msgs::Area> mapAreaMsg_;
+std::set<unsigned int> changedAreas_;
+std::vector<unsigned int> removedAreas_;
+bool forceAreaList_ = true;
+
 ros::NodeHandle* node_;
 
 geometry_msgs::Polygon polygonToRos(unsigned int id) {
     geometry_msgs::Polygon poly;
     geometry_msgs::Point32 curPoint;
-    std::vector<bg::model::d2::point_xy<double> > polyPoints = ((PolygonArea*) mapArea_[id])->poly_.outer();
+    const std::vector<bg::model::d2::point_xy<double> >& polyPoints = ((PolygonArea*) mapArea_[id])->poly_.outer();
     for (unsigned int i = 0; i < polyPoints.size(); ++i) {
         curPoint.x = polyPoints[i].get<0>();
         curPoint.y = polyPoints[i].get<1>();
@@ -51,56 +90,95 @@ geometry_msgs::Polygon polygonToRos(unsigned int id) {
     return poly;
 }
 
-void setAreaMsg(toaster_msgs::AreaList& areaList_msg) {
-    toaster_msgs::Area area;
-    for (std::map<unsigned int, Area*>::iterator it = mapArea_.begin(); it != mapArea_.end(); ++it) {
-        area.id = it->second->getId();
-        area.name = it->second->getName();
+void setAreaMsg(unsigned int id, toaster_msgs::Area& area) {
+    Area* curArea = mapArea_[id];
+    area.id = curArea->getId();
+    area.name = curArea->getName();
 
-        //If it is a circle area
-        if (it->second->getIsCircle()) {
-            area.center.x = ((CircleArea*) it->second)->getCenter().get<0>();
-            area.center.y = ((CircleArea*) it->second)->getCenter().get<1>();
-            area.center.z = ((CircleArea*) it->second)->getCenter().get<2>();
-            area.ray = ((CircleArea*) it->second)->getRay();
-            area.height = ((CircleArea*) it->second)->getHeight();
-        } else {
-            //If it is a polygon
-            area.poly = polygonToRos(it->first);
-            area.zmin = ((PolygonArea*) it->second)->z.get<0>();
-            area.zmax = ((PolygonArea*) it->second)->z.get<1>(); 
-        }
-
-        area.isCircle = it->second->getIsCircle();
-        area.entityType = it->second->getEntityType();
-        area.factType = it->second->getFactType();
-        area.myOwner = it->second->getMyOwner();
-        area.areaType = it->second->getAreaType();
+    //If it is a circle area
+    if (curArea->getIsCircle()) {
+        area.center.x = ((CircleArea*) curArea)->getCenter().get<0>();
+        area.center.y = ((CircleArea*) curArea)->getCenter().get<1>();
+        area.center.z = ((CircleArea*) curArea)->getCenter().get<2>();
+        area.ray = ((CircleArea*) curArea)->getRay();
+        area.height = ((CircleArea*) curArea)->getHeight();
+    } else {
+        //If it is a polygon
+        area.poly = polygonToRos(id);
+        area.zmin = ((PolygonArea*) curArea)->z.get<0>();
+        area.zmax = ((PolygonArea*) curArea)->z.get<1>(); 
+    }
 
-        areaList_msg.areaList.push_back(area);
+    std::map<unsigned int, AreaVolume>::iterator itVolume = mapAreaVolume_.find(id);
+    area.isVolume = (itVolume != mapAreaVolume_.end());
+    area.isBox = area.isVolume && itVolume->second.isBox;
+    if (area.isBox) {
+        const areaBox_t& box = itVolume->second.box;
+        area.center.x = box.center[0];
+        area.center.y = box.center[1];
+        area.center.z = box.center[2];
+        area.boxSize.x = box.size[0];
+        area.boxSize.y = box.size[1];
+        area.boxSize.z = box.size[2];
+        area.boxYaw = box.yaw;
+
+        // The box of an owned area is given relative to its owner, it is
+        // published where the owner put it at its last update
+        std::map<unsigned int, ownerPose_t>::iterator itPose = mapOwnerPose_.find(id);
+        if (curArea->getMyOwner() != "" && itPose != mapOwnerPose_.end()) {
+            const ownerPose_t& owner = itPose->second;
+            area.center.x = cos(owner.theta) * box.center[0] - sin(owner.theta) * box.center[1] + owner.x;
+            area.center.y = sin(owner.theta) * box.center[0] + cos(owner.theta) * box.center[1] + owner.y;
+            area.center.z = box.center[2] + owner.z;
+            area.boxYaw = box.yaw + owner.theta;
+        }
     }
 
+    area.isCircle = curArea->getIsCircle();
+    area.entityType = curArea->getEntityType();
+    area.factType = curArea->getFactType();
+    area.myOwner = curArea->getMyOwner();
+    area.areaType = curArea->getAreaType();
+    area.version = mapAreaVersion_[id];
 }
 
-bool areaCompatible(std::string areaEntType, EntityType entType) {
-    if (entType == ROBOT) {
-        if (areaEntType == "robots" || areaEntType == "agents" || areaEntType == "entities")
-            return true;
-        else
-            return false;
+// To call when an area is added or moved, so that it is published again
+void markAreaChanged(unsigned int id) {
+    mapAreaVersion_[id]++;
+    changedAreas_.insert(id);
+    // removed then added again before a publication: only the change is sent
+    removedAreas_.erase(std::remove(removedAreas_.begin(), removedAreas_.end(), id), removedAreas_.end());
+}
 
-    } else if (entType == HUMAN) {
-        if (areaEntType == "humans" || areaEntType == "agents" || areaEntType == "entities")
-            return true;
-        else
-            return false;
+void markAreaRemoved(unsigned int id) {
+    changedAreas_.erase(id);
+    mapAreaMsg_.erase(id);
+    removedAreas_.push_back(id);
+}
 
-    } else if (entType == OBJECT) {
-        if (areaEntType == "objects" || areaEntType == "entities")
-            return true;
-        else
-            return false;
+// Publishes the full list (latched) and the changes, only if an area changed
+void publishAreas(ros::Publisher& area_pub, ros::Publisher& areaUpdate_pub) {
+    if (changedAreas_.empty() && removedAreas_.empty() && !forceAreaList_)
+        return;
+
+    toaster_msgs::AreaUpdate areaUpdate_msg;
+    areaUpdate_msg.header.stamp = ros::Time::now();
+    for (std::set<unsigned int>::iterator it = changedAreas_.begin(); it != changedAreas_.end(); ++it) {
+        setAreaMsg(*it, mapAreaMsg_[*it]);
+        areaUpdate_msg.changedAreas.push_back(mapAreaMsg_[*it]);
     }
+    areaUpdate_msg.removedAreas = removedAreas_;
+
+    toaster_msgs::AreaList areaList_msg;
+    for (std::map<unsigned int, toaster_msgs::Area>::iterator it = mapAreaMsg_.begin(); it != mapAreaMsg_.end(); ++it)
+        areaList_msg.areaList.push_back(it->second);
+
+    area_pub.publish(areaList_msg);
+    areaUpdate_pub.publish(areaUpdate_msg);
+
+    changedAreas_.clear();
+    removedAreas_.clear();
+    forceAreaList_ = false;
 }
 
 // Entity should be a vector or a map with all entities
@@ -154,43 +232,97 @@ void rotateTranslate(Entity* rotEnt, CircleArea* circleArea) {
 void rotateTranslate(Entity* rotEnt, PolygonArea* polyArea) {
 
     double theta = rotEnt->getOrientation()[2];
-    bg::model::polygon<bg::model::d2::point_xy<double> > newPoly;
-
-    std::vector<bg::model::d2::point_xy<double> > polyPointsRelative = polyArea->getPolyRelative().outer();
-
-    //Just to init with something...
-    std::vector<bg::model::d2::point_xy<double> > polyPoints = polyArea->getPolyRelative().outer();
-
-
-    for (unsigned int i = 0; i < polyPoints.size(); ++i) {
-
-        polyPoints[i].set<0>(cos(theta) * polyPointsRelative[i].get<0>() - sin(theta) * polyPointsRelative[i].get<1>());
-        polyPoints[i].set<1>(sin(theta) * polyPointsRelative[i].get<0>() + cos(theta) * polyPointsRelative[i].get<1>());
-        polyPoints[i].set<0>(polyPoints[i].get<0>() + rotEnt->getPosition().get<0>());
-        polyPoints[i].set<1>(polyPoints[i].get<1>() + rotEnt->getPosition().get<1>());
-        bg::append(newPoly, polyPoints[i]);
-
+    double cosTheta = cos(theta);
+    double sinTheta = sin(theta);
+    double x = rotEnt->getPosition().get<0>();
+    double y = rotEnt->getPosition().get<1>();
+
+    // The transformed polygon is written in place in poly_, which keeps its storage between updates
+    const bg::model::polygon<bg::model::d2::point_xy<double> >& polyRelative = polyArea->getPolyRelative();
+    const std::vector<bg::model::d2::point_xy<double> >& polyPointsRelative = polyRelative.outer();
+    std::vector<bg::model::d2::point_xy<double> >& polyPoints = polyArea->poly_.outer();
+    polyPoints.resize(polyPointsRelative.size());
+
+    for (unsigned int i = 0; i < polyPointsRelative.size(); ++i) {
+        polyPoints[i].set<0>(cosTheta * polyPointsRelative[i].get<0>() - sinTheta * polyPointsRelative[i].get<1>() + x);
+        polyPoints[i].set<1>(sinTheta * polyPointsRelative[i].get<0>() + cosTheta * polyPointsRelative[i].get<1>() + y);
     }
-    polyArea->poly_ = newPoly;
+
     double zmin = polyArea->getZRelative().get<0>() + rotEnt->getPosition().get<2>();
     double zmax = polyArea->getZRelative().get<1>() + rotEnt->getPosition().get<2>();
     polyArea->z = boost::make_tuple(zmin , zmax);
     
 }
 
+// Returns true if the owner moved enough since the last update of this area
+bool ownerMoved(Entity* owner, unsigned int areaId) {
+    std::map<unsigned int, ownerPose_t>::iterator itPose = mapOwnerPose_.find(areaId);
+    double theta = owner->getOrientation()[2];
+
+    if (itPose != mapOwnerPose_.end()
+            && fabs(itPose->second.x - owner->getPosition().get<0>()) < ownerMoveThreshold_
+            && fabs(itPose->second.y - owner->getPosition().get<1>()) < ownerMoveThreshold_
+            && fabs(itPose->second.z - owner->getPosition().get<2>()) < ownerMoveThreshold_
+            && fabs(itPose->second.theta - theta) < ownerMoveThreshold_)
+        return false;
+
+    ownerPose_t& pose = mapOwnerPose_[areaId];
+    pose.x = owner->getPosition().get<0>();
+    pose.y = owner->getPosition().get<1>();
+    pose.z = owner->getPosition().get<2>();
+    pose.theta = theta;
+    return true;
+}
+
 void updateEntityArea(std::map<unsigned int, Area*>& mpArea, Entity * entity) {
-    for (std::map<unsigned int, Area*>::iterator it = mpArea.begin(); it != mpArea.end(); ++it) {
-        if (it->second->getMyOwner() == entity->getId()) {
+    std::map<std::string, std::vector<unsigned int> >::iterator itOwner = mapOwnerAreas_.find(entity->getId());
+    if (itOwner == mapOwnerAreas_.end())
+        return;
 
-            if (it->second->getIsCircle()) {
-                rotateTranslate(entity, ((CircleArea*) it->second));
-            } else {
-                rotateTranslate(entity, ((PolygonArea*) it->second));
-            }
+    for (unsigned int i = 0; i < itOwner->second.size(); ++i) {
+        std::map<unsigned int, Area*>::iterator it = mpArea.find(itOwner->second[i]);
+        if (it == mpArea.end() || !ownerMoved(entity, it->first))
+            continue;
+
+        if (it->second->getIsCircle()) {
+            rotateTranslate(entity, ((CircleArea*) it->second));
+        } else {
+            rotateTranslate(entity, ((PolygonArea*) it->second));
+
+            std::map<unsigned int, AreaVolume>::iterator itVolume = mapAreaVolume_.find(it->first);
+            if (itVolume != mapAreaVolume_.end())
+                itVolume->second.build((PolygonArea*) it->second);
         }
+        areaIndex_.update(it->first);
+        markAreaChanged(it->first);
     }
 }
 
+// Keeps mapOwnerAreas_ consistent when an area is added or removed
+void removeOwnedArea(unsigned int id) {
+    mapOwnerPose_.erase(id);
+    std::map<unsigned int, Area*>::iterator it = mapArea_.find(id);
+    if (it == mapArea_.end() || it->second->getMyOwner() == "")
+        return;
+
+    std::vector<unsigned int>& owned = mapOwnerAreas_[it->second->getMyOwner()];
+    owned.erase(std::remove(owned.begin(), owned.end(), id), owned.end());
+    if (owned.empty())
+        mapOwnerAreas_.erase(it->second->getMyOwner());
+}
+
+// Entities no longer belong to a removed area, so that its counts start from scratch if added again
+void clearInArea(unsigned int id) {
+    for (std::map<std::string, Entity*>::iterator it = mapEntities_.begin(); it != mapEntities_.end(); ++it)
+        if (it->second->isInArea(id))
+            it->second->removeInArea(id);
+}
+
+void addOwnedArea(Area* area) {
+    if (area->getMyOwner() != "")
+        mapOwnerAreas_[area->getMyOwner()].push_back(area->getId());
+}
+
 /**
 void updateInArea(Entity* ent, std::map<unsigned int, Area*>& mpArea) {
 	//ROS_INFO("Inside the function");
@@ -230,46 +362,81 @@ void updateInArea(Entity* ent, std::map<unsigned int, Area*>& mpArea) {
 }
 **/
 
+// Enter / leave transitions, sent on area_manager/areaEvent
+AreaEventStream areaEvents_;
+
+// Print transitions on stdout
+bool verbose_ = false;
+
+// Entities are updated in parallel: an area and its rule are only modified under its lock
+const unsigned int NB_AREA_MUTEX = 64;
+std::mutex areaMutex_[NB_AREA_MUTEX];
+
+// Tests if ent is in area, with the volume of the area if it has one.
+// To call under the area lock.
+bool isEntityInArea(Area* area, Entity* ent) {
+    std::map<unsigned int, AreaVolume>::const_iterator itVolume = mapAreaVolume_.find(area->getId());
+    if (itVolume == mapAreaVolume_.end())
+        return area->isPointInArea(ent->getPosition(), ent->getId());
+
+    bool wasInside = ent->isInArea(area->getId());
+    bool inside = itVolume->second.contains(ent->getPosition(), wasInside);
+    if (inside && !wasInside)
+        area->insideEntities_.push_back(ent->getId());
+    return inside;
+}
+
 void updateInArea(Entity* ent, std::map<unsigned int, Area*>& mpArea) {
-	//ROS_INFO("Inside the function");
-    for (std::map<unsigned int, Area*>::iterator it = mpArea.begin(); it != mpArea.end(); ++it) {
-        // if the entity is actually concerned, and is not the owner
-        //ROS_INFO("entity's type : %s, area's type : %s",areaCompatible(it->second->getEntityType().ToString("") ,ent->getEntityType().ToString(""));
-        if (areaCompatible(it->second->getEntityType(), ent->getEntityType()) && it->second->getMyOwner() != ent->getId()) {
+    // Areas the entity is already in are always checked, so that leaving is detected
+    std::vector<unsigned int> inAreas = ent->inArea_;
+    std::set<unsigned int> leftAreas;
+    for (unsigned int i = 0; i < inAreas.size(); ++i) {
+        std::map<unsigned int, Area*>::iterator it = mpArea.find(inAreas[i]);
+        if (it == mpArea.end())
+            continue;
 
-            // If we already know that entity is in Area, we update if needed.
-            if (ent->isInArea(it->second->getId()))
-                if (it->second->isPointInArea(ent->getPosition(), ent->getId()))
-                    continue;
-                else {
-                    printf("[area_manager] %s leaves Area %s\n", ent->getName().c_str(), it->second->getName().c_str());
-                    ent->removeInArea(it->second->getId());
-                    it->second->removeInsideEntity(ent->getId());
-                    if (it->second->getAreaType() == "room")
-                        ent->setRoomId(0);
-                }// Same if entity is not in Area
-            else
-                if (it->second->isPointInArea(ent->getPosition(),ent->getId())) {
-                printf("[area_manager] %s enters in Area %s\n", ent->getName().c_str(), it->second->getName().c_str());
+        areaRule_t& rule = mapAreaRule_.find(it->first)->second;
+        std::lock_guard<std::mutex> lock(areaMutex_[it->first % NB_AREA_MUTEX]);
+        if (!isEntityInArea(it->second, ent)) {
+            if (verbose_)
+                printf("[area_manager] %s leaves Area %s\n", ent->getName().c_str(), it->second->getName().c_str());
+            areaEvents_.transition(ent, it->second, false);
+            ent->removeInArea(it->second->getId());
+            it->second->removeInsideEntity(ent->getId());
+            leftAreas.insert(it->first);
+
+            leaveAreaRule(rule, ent);
+            if (rule.areaType == ROOM_AREA)
+                ent->setRoomId(0);
+        }
+    }
+
+    // Then only the areas which bounding box contains the entity can be entered
+    std::vector<unsigned int> candidates;
+    areaIndex_.query(ent->getPosition(), candidates);
+    for (unsigned int i = 0; i < candidates.size(); ++i) {
+        std::map<unsigned int, Area*>::iterator it = mpArea.find(candidates[i]);
+        if (it == mpArea.end() || ent->isInArea(it->first) || leftAreas.count(it->first))
+            continue;
+
+        // if the entity is actually concerned, and is not the owner
+        areaRule_t& rule = mapAreaRule_.find(it->first)->second;
+        if (areaCompatible(rule, ent->getEntityType()) && rule.ownerId != ent->getId()) {
+            std::lock_guard<std::mutex> lock(areaMutex_[it->first % NB_AREA_MUTEX]);
+            if (isEntityInArea(it->second, ent)) {
+                if (verbose_)
+                    printf("[area_manager] %s enters in Area %s\n", ent->getName().c_str(), it->second->getName().c_str());
+                areaEvents_.transition(ent, it->second, true);
                 ent->inArea_.push_back(it->second->getId());
+                enterAreaRule(rule, ent);
 
                 //User has to be in a room. May it be a "global room".
-                if (it->second->getAreaType() == "room")
+                if (rule.areaType == ROOM_AREA)
                     ent->setRoomId(it->second->getId());
-            } else {
-                //printf("[area_manager][DEGUG] %s is not in Area %s, he is in %f, %f\n", ent->getName().c_str(), it->second->getName().c_str(), ent->getPosition().get<0>(), ent->getPosition().get<1>());
-                continue;
             }
-        } else {
-            continue;
         }
     }
 }
-// Return confidence: 0.0 if not facing 1.0 if facing
-
-double isFacing(Entity* entFacing, Entity* entSubject, double angleThreshold, double& angleResult) {
-    return MathFunctions::isInAngle(entFacing, entSubject, entFacing->getOrientation()[2], angleThreshold, angleResult);
-}
 
 void printMyArea(unsigned int id) {
     if (mapArea_[id]->getIsCircle())
@@ -303,6 +470,17 @@ unsigned int getFreeId(std::map<unsigned int, Area*>& map) {
 }
 
 
+Entity* findOwner(const std::string& ownerId, ToasterHumanReader& humanRd, ToasterRobotReader& robotRd, ToasterObjectReader& objectRd) {
+    if (robotRd.lastConfig_.find(ownerId) != robotRd.lastConfig_.end())
+        return robotRd.lastConfig_[ownerId];
+    else if (humanRd.lastConfig_.find(ownerId) != humanRd.lastConfig_.end())
+        return humanRd.lastConfig_[ownerId];
+    else if (objectRd.lastConfig_.find(ownerId) != objectRd.lastConfig_.end())
+        return objectRd.lastConfig_[ownerId];
+    return NULL;
+}
+
+
 ///////////////////////////
 //   Service functions   //
 ///////////////////////////
@@ -320,11 +498,31 @@ bool addArea(toaster_msgs::AddArea::Request &req,
         id = req.myArea.id;
 
 
+    bool isVolume = !req.myArea.isCircle && (req.myArea.isVolume || req.myArea.isBox);
+    AreaVolume volume;
+
     //If it is a circle area
     if (req.myArea.isCircle) {
         bg::model::point<double, 3, bg::cs::cartesian> center(req.myArea.center.x, req.myArea.center.y, req.myArea.center.z);
         CircleArea* myCircle = new CircleArea(id, center, req.myArea.ray, req.myArea.height, req.myArea.enterHysteresis, req.myArea.leaveHysteresis);
         curArea = myCircle;
+    } else if (req.myArea.isBox) {
+        //If it is an oriented box, it is kept as its rectangle
+        volume.isBox = true;
+        volume.box.center[0] = req.myArea.center.x;
+        volume.box.center[1] = req.myArea.center.y;
+        volume.box.center[2] = req.myArea.center.z;
+        volume.box.size[0] = req.myArea.boxSize.x;
+        volume.box.size[1] = req.myArea.boxSize.y;
+        volume.box.size[2] = req.myArea.boxSize.z;
+        volume.box.yaw = req.myArea.boxYaw;
+
+        double pointsPoly[4][2];
+        AreaVolume::boxCorners(volume.box, pointsPoly);
+        double zmin = req.myArea.center.z - req.myArea.boxSize.z / 2.0;
+        double zmax = req.myArea.center.z + req.myArea.boxSize.z / 2.0;
+
+        curArea = new PolygonArea(id, pointsPoly, 4, zmin, zmax, req.myArea.enterHysteresis, req.myArea.leaveHysteresis);
     } else {
         //If it is a polygon
         double pointsPoly[req.myArea.poly.points.size()][2];
@@ -345,7 +543,21 @@ bool addArea(toaster_msgs::AddArea::Request &req,
     curArea->setName(req.myArea.name);
     curArea->setAreaType(req.myArea.areaType);
 
+    removeOwnedArea(curArea->getId());
+    clearInArea(curArea->getId());
+    areaEvents_.removeArea(curArea->getId());
     mapArea_[curArea->getId()] = curArea;
+    mapAreaRule_[curArea->getId()] = makeAreaRule(curArea);
+    if (isVolume) {
+        volume.enterHysteresis = req.myArea.enterHysteresis;
+        volume.leaveHysteresis = req.myArea.leaveHysteresis;
+        volume.build((PolygonArea*) curArea);
+        mapAreaVolume_[curArea->getId()] = volume;
+    } else
+        mapAreaVolume_.erase(curArea->getId());
+    addOwnedArea(curArea);
+    markAreaChanged(curArea->getId());
+    areaIndex_.insert(curArea, std::max(req.myArea.enterHysteresis, req.myArea.leaveHysteresis));
 
     res.answer = true;
     ROS_INFO("request: added Area: id %d, name %s", req.myArea.id, req.myArea.name.c_str());
@@ -357,8 +569,16 @@ bool removeArea(toaster_msgs::RemoveArea::Request &req,
         toaster_msgs::RemoveArea::Response & res) {
 
     ROS_INFO("request: removed Area: id %d, named: %s", req.id, mapArea_[req.id]->getName().c_str());
-    if (mapArea_.find(req.id) != mapArea_.end())
+    if (mapArea_.find(req.id) != mapArea_.end()) {
+        removeOwnedArea(req.id);
+        clearInArea(req.id);
+        areaEvents_.removeArea(req.id);
         mapArea_.erase(req.id);
+        mapAreaRule_.erase(req.id);
+        mapAreaVolume_.erase(req.id);
+        areaIndex_.remove(req.id);
+        markAreaRemoved(req.id);
+    }
 
     res.answer = true;
     ROS_INFO("sending back response: [%d]", (int) res.answer);
@@ -369,7 +589,17 @@ bool removeAllAreas(toaster_msgs::Empty::Request &req,
         toaster_msgs::Empty::Response & res) {
 
     ROS_INFO("request: remove all areas");
+    for (std::map<unsigned int, Area*>::iterator it = mapArea_.begin(); it != mapArea_.end(); ++it) {
+        clearInArea(it->first);
+        areaEvents_.removeArea(it->first);
+        markAreaRemoved(it->first);
+    }
     mapArea_.clear();
+    mapAreaRule_.clear();
+    mapAreaVolume_.clear();
+    areaIndex_.clear();
+    mapOwnerAreas_.clear();
+    mapOwnerPose_.clear();
     return true;
 }
 
@@ -395,38 +625,54 @@ bool printAllAreas(toaster_msgs::Empty::Request &req,
     return true;
 }
 
+// Gives the direction of a target from its relative angle (positive at right)
+
+std::string angleToDirection(double angleResult) {
+    double pi = 3.1416;
+
+    if (angleResult > 0) {
+        if (angleResult < pi / 6)
+            return "ahead";
+        else if (angleResult < pi / 4)
+            return "ahead right";
+        else if (angleResult < 3 * pi / 4)
+            return "right";
+        else if (angleResult < 5 * pi / 6)
+            return "back right";
+        else
+            return "back";
+    } else {
+        if (-angleResult < pi / 6)
+            return "ahead";
+        else if (-angleResult < pi / 4)
+            return "ahead left";
+        else if (-angleResult < 3 * pi / 4)
+            return "left";
+        else if (-angleResult < 5 * pi / 6)
+            return "back left";
+        else
+            return "back";
+    }
+}
+
+Entity* findEntity(const std::string& id) {
+    std::map<std::string, Entity*>::iterator it = mapEntities_.find(id);
+    if (it != mapEntities_.end())
+        return it->second;
+    return NULL;
+}
+
 // This function is used to get relative position of an entity according to another (left / right))
 
 bool getRelativePosition(toaster_msgs::GetRelativePosition::Request &req,
         toaster_msgs::GetRelativePosition::Response & res) {
-    double pi = 3.1416;
+    Entity* subject = findEntity(req.subjectId);
+    Entity* target = findEntity(req.targetId);
 
-    if (mapEntities_.find(req.subjectId) != mapEntities_.end() && mapEntities_.find(req.targetId) != mapEntities_.end()) {
+    if (subject != NULL && target != NULL) {
         double angleResult;
-        angleResult = MathFunctions::relativeAngle(mapEntities_[req.subjectId], mapEntities_[req.targetId], mapEntities_[req.subjectId]->getOrientation()[2]);
-        if (angleResult > 0) {
-            if (angleResult < pi / 6)
-                res.direction = "ahead";
-            else if (angleResult < pi / 4)
-                res.direction = "ahead right";
-            else if (angleResult < 3 * pi / 4)
-                res.direction = "right";
-            else if (angleResult < 5 * pi / 6)
-                res.direction = "back right";
-            else
-                res.direction = "back";
-        } else {
-            if (-angleResult < pi / 6)
-                res.direction = "ahead";
-            else if (-angleResult < pi / 4)
-                res.direction = "ahead left";
-            else if (-angleResult < 3 * pi / 4)
-                res.direction = "left";
-            else if (-angleResult < 5 * pi / 6)
-                res.direction = "back left";
-            else
-                res.direction = "back";
-        }
+        angleResult = MathFunctions::relativeAngle(subject, target, subject->getOrientation()[2]);
+        res.direction = angleToDirection(angleResult);
 
         res.answer = true;
         res.angleValue = angleResult;
@@ -441,36 +687,15 @@ bool getRelativePosition(toaster_msgs::GetRelativePosition::Request &req,
 
 bool getMultiRelativePosition(toaster_msgs::GetMultiRelativePosition::Request &req,
         toaster_msgs::GetMultiRelativePosition::Response & res) {
-    double pi = 3.1416;
+    Entity* agentSubject = findEntity(req.agentSubjectId);
+    Entity* objectSubject = findEntity(req.objectSubjectId);
+    Entity* target = findEntity(req.targetId);
 
-    // [TODO] Replace with find
-    if (mapEntities_[req.agentSubjectId] != NULL && mapEntities_[req.objectSubjectId] != NULL && mapEntities_[req.targetId] != NULL) {
+    if (agentSubject != NULL && objectSubject != NULL && target != NULL) {
         double angleSubjects, angleResult;
-        angleSubjects = MathFunctions::relativeAngle(mapEntities_[req.agentSubjectId], mapEntities_[req.objectSubjectId], 0);
-        angleResult = MathFunctions::relativeAngle(mapEntities_[req.objectSubjectId], mapEntities_[req.targetId], angleSubjects);
-        if (angleResult > 0) {
-            if (angleResult < pi / 6)
-                res.direction = "ahead";
-            else if (angleResult < pi / 4)
-                res.direction = "ahead right";
-            else if (angleResult < 3 * pi / 4)
-                res.direction = "right";
-            else if (angleResult < 5 * pi / 6)
-                res.direction = "back right";
-            else
-                res.direction = "back";
-        } else {
-            if (-angleResult < pi / 6)
-                res.direction = "ahead";
-            else if (-angleResult < pi / 4)
-                res.direction = "ahead left";
-            else if (-angleResult < 3 * pi / 4)
-                res.direction = "left";
-            else if (-angleResult < 5 * pi / 6)
-                res.direction = "back left";
-            else
-                res.direction = "back";
-        }
+        angleSubjects = MathFunctions::relativeAngle(agentSubject, objectSubject, 0);
+        angleResult = MathFunctions::relativeAngle(objectSubject, target, angleSubjects);
+        res.direction = angleToDirection(angleResult);
 
         res.answer = true;
         res.angleValue = angleResult;
@@ -481,10 +706,76 @@ bool getMultiRelativePosition(toaster_msgs::GetMultiRelativePosition::Request &r
     return false;
 }
 
+// This function computes the relative positions of several targets in one call.
+// subjectIds gives the subject of each target, or a single subject for all targets.
+// If agentSubjectId is set, positions are given in this agent point of view, as in getMultiRelativePosition.
+
+bool getRelativePositionsMatrix(toaster_msgs::GetRelativePositionsMatrix::Request &req,
+        toaster_msgs::GetRelativePositionsMatrix::Response & res) {
+    unsigned int nbTargets = req.targetIds.size();
+    bool oneSubject = (req.subjectIds.size() == 1);
+
+    if (!oneSubject && req.subjectIds.size() != nbTargets) {
+        ROS_WARN("[area_manager] get_relative_positions_matrix needs one subject, or one subject per target.");
+        res.answer = false;
+        return false;
+    }
+
+    Entity* agentSubject = NULL;
+    if (req.agentSubjectId != "") {
+        agentSubject = findEntity(req.agentSubjectId);
+        if (agentSubject == NULL) {
+            ROS_INFO("Requested entity is not in the list.");
+            res.answer = false;
+            return false;
+        }
+    }
+
+    res.directions.resize(nbTargets);
+    res.angleValues.resize(nbTargets);
+    res.found.resize(nbTargets);
+
+    // Reference angle of each subject, computed once per subject
+    std::map<std::string, std::pair<Entity*, double> > subjects;
+
+    for (unsigned int i = 0; i < nbTargets; ++i) {
+        const std::string& subjectId = oneSubject ? req.subjectIds[0] : req.subjectIds[i];
+
+        std::map<std::string, std::pair<Entity*, double> >::iterator itSubject = subjects.find(subjectId);
+        if (itSubject == subjects.end()) {
+            Entity* subject = findEntity(subjectId);
+            double angleSubject = 0.0;
+            if (subject != NULL) {
+                if (agentSubject != NULL)
+                    angleSubject = MathFunctions::relativeAngle(agentSubject, subject, 0);
+                else
+                    angleSubject = subject->getOrientation()[2];
+            }
+            itSubject = subjects.insert(std::make_pair(subjectId, std::make_pair(subject, angleSubject))).first;
+        }
+
+        Entity* target = findEntity(req.targetIds[i]);
+        if (itSubject->second.first == NULL || target == NULL) {
+            res.found[i] = false;
+            res.angleValues[i] = 0.0;
+            continue;
+        }
+
+        double angleResult = MathFunctions::relativeAngle(itSubject->second.first, target, itSubject->second.second);
+        res.found[i] = true;
+        res.angleValues[i] = angleResult;
+        res.directions[i] = angleToDirection(angleResult);
+    }
+
+    res.answer = true;
+    return true;
+}
+
 bool publishAllAreas(toaster_msgs::Empty::Request &req,
         toaster_msgs::Empty::Response & res) {
 
     publishingArea_ = !publishingArea_;
+    forceAreaList_ = true;
     ROS_INFO("request: publishing area: %d", publishingArea_);
     return true;
 }
@@ -524,16 +815,41 @@ int main(int argc, char** argv) {
     ros::ServiceServer serviceMultiRelativePose = node.advertiseService("area_manager/get_multiple_relative_position", getMultiRelativePosition);
     ROS_INFO("Ready to print get relative position in an agent perspective.");
 
+    ros::ServiceServer serviceRelativePoseMatrix = node.advertiseService("area_manager/get_relative_positions_matrix", getRelativePositionsMatrix);
+    ROS_INFO("Ready to get relative positions of several entities.");
+
     ros::ServiceServer servicepublishAllArea = node.advertiseService("area_manager/publish_all_areas", publishAllAreas);
     ROS_INFO("Ready to publish all areas.");
 
     // Publishing
     ros::Publisher fact_pub = node.advertise<toaster_msgs::FactList>("area_manager/factList", 1000);
-    ros::Publisher area_pub = node_->advertise<toaster_msgs::AreaList>("area_manager/areaList", 1000);
+    // Latched, as it is only sent when an area changes
+    ros::Publisher area_pub = node_->advertise<toaster_msgs::AreaList>("area_manager/areaList", 1, true);
+    ros::Publisher areaUpdate_pub = node_->advertise<toaster_msgs::AreaUpdate>("area_manager/areaUpdate", 100);
+    ros::Publisher areaEvent_pub = node.advertise<toaster_msgs::AreaEvent>("area_manager/areaEvent", 1000);
 
     // Set this in a ros service?
     ros::Rate loop_rate(30);
 
+    // Threads used to update entities in areas
+    int nbThreads = std::thread::hardware_concurrency();
+    if (node.hasParam("/area_manager/nbThreads"))
+        node.getParam("/area_manager/nbThreads", nbThreads);
+    WorkerPool workers(nbThreads > 0 ? nbThreads : 1);
+    ROS_INFO("Updating areas with %d threads.", workers.size());
+
+    double eventDebounce = 0.0;
+    if (node.hasParam("/area_manager/eventDebounce"))
+        node.getParam("/area_manager/eventDebounce", eventDebounce);
+    areaEvents_.setDebounce(eventDebounce * 1e9);
+
+    if (node.hasParam("/area_manager/verbose"))
+        node.getParam("/area_manager/verbose", verbose_);
+
+    std::vector<std::pair<std::string, Entity*> > entities;
+    std::vector<toaster_msgs::AreaEvent> areaEvents;
+    std::vector<toaster_msgs::FactList> workerFacts(workers.size());
+
 
 
     /************************/
@@ -543,9 +859,6 @@ int main(int argc, char** argv) {
     //TODO: remove human / robot id and do it for all
     while (node.ok()) {
         toaster_msgs::FactList factList_msg;
-        toaster_msgs::Fact fact_msg;
-
-        toaster_msgs::AreaList areaList_msg;
 
         ////////////////////////////////
         // Updating situational Areas //
@@ -557,6 +870,9 @@ int main(int argc, char** argv) {
         //     get area owner
         //     update area with owner position
 
+        // Entities are those of the readers at this loop, so that gone ones are forgotten
+        mapEntities_.clear();
+
         // Humans
         for (std::map<std::string, Human*>::iterator it = humanRd.lastConfig_.begin(); it != humanRd.lastConfig_.end(); ++it) {
             // We update area with human center
@@ -581,210 +897,56 @@ int main(int argc, char** argv) {
         }
 
 
-        /////////////////////////////////
-        // Updating in Area properties //
-        /////////////////////////////////
-
-
-        for (std::map<std::string, Entity*>::iterator it = mapEntities_.begin(); it != mapEntities_.end(); ++it) {
-            // We update area with owners
-            updateInArea(it->second, mapArea_);
-        }
-
-        ///////////////////////////////////////
-        // Computing facts for each entities //
-        ///////////////////////////////////////
-
-        // TODO: replace code by a function for each fact computation
-
-        for (std::map<unsigned int, Area*>::iterator itArea = mapArea_.begin(); itArea != mapArea_.end(); ++itArea) {
-            double areaDensity = 0.0;
-            unsigned long densityTime = 0;
-
-            Entity* ownerEnt = NULL;
-
-            // Computation depending on owner
-            if (itArea->second->getMyOwner() != "") {
-
-                // Let's find back the area owner:
-                if (robotRd.lastConfig_.find(itArea->second->getMyOwner()) != robotRd.lastConfig_.end())
-                    ownerEnt = robotRd.lastConfig_[itArea->second->getMyOwner()];
-
-                else if (humanRd.lastConfig_.find(itArea->second->getMyOwner()) != humanRd.lastConfig_.end())
-                    ownerEnt = humanRd.lastConfig_[itArea->second->getMyOwner()];
-
-                else if (objectRd.lastConfig_.find(itArea->second->getMyOwner()) != objectRd.lastConfig_.end())
-                    ownerEnt = objectRd.lastConfig_[itArea->second->getMyOwner()];
-            }
-
-            for (std::map<std::string, Entity*>::iterator itEntity = mapEntities_.begin(); itEntity != mapEntities_.end(); ++itEntity) {
-
-                if (itEntity->second->isInArea(itArea->first)) {
-
-
-                    // compute facts according to factType
-                    // TODO: instead of calling it interaction, make a list of facts to compute?
-
-
-
-
-                    if (itArea->second->getFactType() == "interaction") {
-
-                        // If it is an interacting area, we need the owner!
-                        if (ownerEnt != NULL) {
-
-                            // Now let's compute isFacing
-                            //////////////////////////////
-
-                            double confidence = 0.0;
-                            // This is the actual angle between subject orientation
-                            // and target. It gives left / right relation
-                            // If positive, target is at right!
-                            double angleResult = 0.0;
-                            confidence = isFacing(itEntity->second, ownerEnt, 0.5, angleResult);
-                            if (confidence > 0.0) {
-                                //printf("[area_manager][DEBUG] %s is facing %s with confidence %f, angleResult %f\n",
-                                       // itEntity->second->getName().c_str(), ownerEnt->getName().c_str(), confidence, angleResult);
-
-                                //Fact Facing
-                                fact_msg.property = "IsFacing";
-                                fact_msg.propertyType = "posture";
-                                fact_msg.subProperty = "angle";
-                                fact_msg.subjectId = itEntity->first;
-                                fact_msg.targetId = ownerEnt->getId();
-                                fact_msg.confidence = confidence;
-                                fact_msg.stringValue = true;
-                                fact_msg.doubleValue = angleResult;
-                                fact_msg.valueType = 0;
-                                fact_msg.factObservability = 0.5;
-                                fact_msg.time = itEntity->second->getTime();
-
-                                factList_msg.factList.push_back(fact_msg);
-                            }
-
-
-                            // Compute here other facts linked to interaction
-                            //////////////////////////////////////////////////
-
-                            // TODO
-
-
-                        } // ownerEnt!= NULL
-
-                    } else if (itArea->second->getFactType() == "density") {
-                        areaDensity += 1.0;
-                        densityTime = itEntity->second->getTime();
-                    } else if (itArea->second->getFactType() == "") {
-
-                    } else {
-                        printf("[area_manager][WARNING] Area %s has factType %s, which is not available\n", itArea->second->getName().c_str(), itArea->second->getFactType().c_str());
-                    }
-
-                    if (itArea->second->getAreaType() == "room") {
-                        //Fact in Area
-                        fact_msg.property = "IsInRoom";
-                        fact_msg.propertyType = "position";
-
-                        fact_msg.subProperty = itArea->second->getAreaType();
-                        if (ownerEnt != NULL) {
-                            fact_msg.targetOwnerId = ownerEnt->getId();
-                        }
-
-                        fact_msg.subjectId = itEntity->first;
-                        fact_msg.targetId = itArea->second->getName();
-                        fact_msg.confidence = 1;
-                        fact_msg.factObservability = 0.8;
-                        fact_msg.time = itEntity->second->getTime();
-                        fact_msg.valueType = 0;
-                        fact_msg.stringValue = "true";
-
-                        factList_msg.factList.push_back(fact_msg);
-                    } else if (itArea->second->getAreaType() == "support") {
-                        //Fact in Area
-                        fact_msg.property = "IsAt";
-                        fact_msg.propertyType = "position";
-
-                        fact_msg.subProperty = "location";
-                        if (ownerEnt != NULL) {
-                            fact_msg.targetOwnerId = ownerEnt->getId();
-                        }
-
-                        fact_msg.subjectId = itEntity->first;
-                        fact_msg.targetId = itArea->second->getName();
-                        fact_msg.confidence = 1;
-                        fact_msg.factObservability = 0.8;
-                        fact_msg.time = itEntity->second->getTime();
-                        fact_msg.valueType = 0;
-                        fact_msg.stringValue = "true";
-
-                        factList_msg.factList.push_back(fact_msg);
-
-                    } else {
-                        //Fact in Area
-                        fact_msg.property = "IsInArea";
-                        fact_msg.propertyType = "position";
-
-                        fact_msg.subProperty = itArea->second->getAreaType();
-                        if (ownerEnt != NULL) {
-                            fact_msg.targetOwnerId = ownerEnt->getId();
-                        }
-
-                        fact_msg.subjectId = itEntity->first;
-                        fact_msg.targetId = itArea->second->getName();
-                        fact_msg.confidence = 1;
-                        fact_msg.factObservability = 0.8;
-                        fact_msg.time = itEntity->second->getTime();
-
-                        factList_msg.factList.push_back(fact_msg);
-                    }
+        ///////////////////////////////////////////////////
+        // Updating in Area properties and computing facts //
+        ///////////////////////////////////////////////////
+
+        population_t population;
+        population.humans = humanRd.lastConfig_.size();
+        population.robots = robotRd.lastConfig_.size();
+        population.objects = objectRd.lastConfig_.size();
+
+        // Let's find back the area owners, once they are known by a reader
+        for (std::map<unsigned int, areaRule_t>::iterator itRule = mapAreaRule_.begin(); itRule != mapAreaRule_.end(); ++itRule)
+            if (itRule->second.owner == NULL && itRule->second.ownerId != "")
+                setAreaOwner(itRule->second, findOwner(itRule->second.ownerId, humanRd, robotRd, objectRd));
+
+        // Each worker takes a contiguous range of entities.
+        // Buffers are merged in worker order so the fact list does not depend on scheduling.
+        entities.assign(mapEntities_.begin(), mapEntities_.end());
+        areaEvents_.setNow(ros::Time::now().toNSec());
+        workers.run([&entities, &workerFacts, &workers](unsigned int worker) {
+            toaster_msgs::FactList& facts = workerFacts[worker];
+            facts.factList.clear();
+
+            unsigned int begin = entities.size() * worker / workers.size();
+            unsigned int end = entities.size() * (worker + 1) / workers.size();
+            for (unsigned int i = begin; i < end; ++i) {
+                Entity* ent = entities[i].second;
+                updateInArea(ent, mapArea_);
+
+                for (unsigned int j = 0; j < ent->inArea_.size(); ++j) {
+                    std::map<unsigned int, Area*>::iterator itArea = mapArea_.find(ent->inArea_[j]);
+                    if (itArea != mapArea_.end())
+                        computeEntityFacts(ent, entities[i].first, itArea->second, mapAreaRule_.find(itArea->first)->second, facts);
                 }
-            }// For all Entities
-
-            // We compute here the density
-            if (itArea->second->getFactType() == "density") {
-                // -1 is a hack to remove centroid
-                int fullPopulation = -1;
-                if (itArea->second->getEntityType() == "humans" || itArea->second->getEntityType() == "agents"
-                        || itArea->second->getEntityType() == "entities")
-                    fullPopulation += humanRd.lastConfig_.size();
-
-                if (itArea->second->getEntityType() == "robots" || itArea->second->getEntityType() == "agents"
-                        || itArea->second->getEntityType() == "entities")
-                    fullPopulation += robotRd.lastConfig_.size();
+            }
+        });
 
-                if (itArea->second->getEntityType() == "objects" || itArea->second->getEntityType() == "entities")
-                    fullPopulation += objectRd.lastConfig_.size();
+        areaEvents_.takeEvents(areaEvents);
+        areaEvents_.keepEntities(entities);
+        for (unsigned int i = 0; i < areaEvents.size(); ++i)
+            areaEvent_pub.publish(areaEvents[i]);
 
-                if (fullPopulation == 0)
-                    areaDensity = 0;
-                else
-                    areaDensity /= fullPopulation;
+        for (unsigned int i = 0; i < workerFacts.size(); ++i)
+            factList_msg.factList.insert(factList_msg.factList.end(), workerFacts[i].factList.begin(), workerFacts[i].factList.end());
 
-                if (ownerEnt != NULL) {
-                    fact_msg.subjectOwnerId = ownerEnt->getId();
-                }
+        // Facts on the whole area, once all entities are updated
+        for (std::map<unsigned int, Area*>::iterator itArea = mapArea_.begin(); itArea != mapArea_.end(); ++itArea)
+            computeAreaFacts(itArea->second, mapAreaRule_[itArea->first], population, factList_msg);
 
-                //Fact Density
-                fact_msg.property = "AreaDensity";
-                fact_msg.propertyType = "density";
-                fact_msg.subProperty = "ratio";
-                fact_msg.subjectId = itArea->first;
-                fact_msg.targetId = "";
-                fact_msg.confidence = 1.0;
-                fact_msg.doubleValue = areaDensity;
-                fact_msg.valueType = 1;
-                fact_msg.factObservability = 0.0;
-                fact_msg.time = densityTime;
-
-                factList_msg.factList.push_back(fact_msg);
-            }// Density
-
-        }// for all area
-
-        if (publishingArea_) {
-            setAreaMsg(areaList_msg);
-            area_pub.publish(areaList_msg);
-        }
+        if (publishingArea_)
+            publishAreas(area_pub, areaUpdate_pub);
 
         fact_pub.publish(factList_msg);
 
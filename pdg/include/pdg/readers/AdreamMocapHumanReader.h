@@ -37,9 +37,16 @@ private:
     ros::Subscriber subTorso_;
     ros::Subscriber subHead_;
     ros::Subscriber subHand_;
+    std::string topicTorso_;
+    std::string topicHead_;
+    std::string topicHand_;
     void optitrackCallbackTorso(const optitrack::or_pose_estimator_state::ConstPtr& msg);
     void optitrackCallbackHead(const optitrack::or_pose_estimator_state::ConstPtr& msg);
     void optitrackCallbackHand(const optitrack::or_pose_estimator_state::ConstPtr& msg);
+
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif	/* ADREAMMOCAPHUMANREADER_H */
@@ -25,6 +25,11 @@ public:
 
 private:
     void CallbackObj(const visualization_msgs::Marker::ConstPtr& msg);
+    std::string topic_;
+
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif	/* AROBJECTREADER_H */
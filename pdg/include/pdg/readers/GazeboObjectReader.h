@@ -25,6 +25,11 @@ public:
 
 private:
     void CallbackObj(const gazebo_msgs::ModelStates::ConstPtr& msg);
+    std::string topic_;
+
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif	/* GAZEBOOBJECTREADER_H */
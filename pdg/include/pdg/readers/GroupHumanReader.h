@@ -9,6 +9,7 @@
 #define	GROUPHUMANREADER_H
 
 #include "HumanReader.h"
+#include "pdg/utility/TfQueue.h"
 
 #include <ros/ros.h>
 #include "tf/transform_listener.h"
@@ -26,7 +27,14 @@ public:
 private:
     ros::Subscriber sub_;
     void groupTrackCallback(const spencer_tracking_msgs::TrackedGroups::ConstPtr& msg);
+    void groupTrackTransformable(const spencer_tracking_msgs::TrackedGroups::ConstPtr& msg);
     tf::TransformListener* listener_;
+    TfQueue<spencer_tracking_msgs::TrackedGroups> tfQueue_;
+    std::string topic_;
+
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif	/* GROUPHUMANREADER_H */
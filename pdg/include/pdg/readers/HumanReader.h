@@ -17,6 +17,8 @@
 #include "toaster-lib/Human.h"
 #include "pdg/readers/Reader.h"
 #include "pdg/types.h"
+#include "pdg/utility/ListBuffer.h"
+#include "pdg/utility/EntityLifecycle.h"
 #include <map>
 #include <string>
 
@@ -31,10 +33,19 @@ class HumanReader : public Reader<Human>{
 
       bool isPresent(std::string id);
 
+      // Times in ns before a human is not present, then before it is forgotten
+      void setLifecycleTimes(uint64_t staleTime, uint64_t evictTime) {lifecycle_.setTimes(staleTime, evictTime); }
+
       virtual void Publish(struct toasterList_t& list_msg);
 
+    protected:
+      EntityLifecycle lifecycle_;
+
+      // To call with the config locked, before publishing humans
+      void updateLifecycle(struct toasterList_t& list_msg);
+
     public:
-      toaster_msgs::Fact DefaultFactMsg(std::string subjectId, uint64_t factTime);
+      void DefaultFactMsg(toaster_msgs::Fact& fact_msg, const std::string& subjectId, uint64_t factTime);
 };
 
 
@@ -23,6 +23,11 @@ private:
     ros::Subscriber sub_;
     void optitrackCallback(const spencer_tracking_msgs::TrackedPersons::ConstPtr& msg);
     tf::TransformListener* listener_;
+    std::string topic_;
+
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif
@@ -31,6 +31,7 @@ class MorseHumanReader : public HumanReader
   private:
     //static void humanJointStateCallBack(const sensor_msgs::JointState::ConstPtr& msg);
     ros::Subscriber sub_;
+    ros::Duration tfTimeout_;
 };
 
 #endif /* MORSEHUMANREADER_H */
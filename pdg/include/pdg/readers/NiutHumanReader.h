@@ -34,7 +34,11 @@ private:
     void projectJoint(Joint& joint, double* kinectPos);
     void updateJoint(int i, int j, Joint& curJoint, std::string toasterId, std::vector<int>& trackedJoints,
             const niut_msgs::niut_HUMAN_LIST::ConstPtr& msg);
+    std::string topic_;
 
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif /* NIUTHUMANREADER_H */
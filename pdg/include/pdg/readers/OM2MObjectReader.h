@@ -12,7 +12,7 @@
 #include <string>
 #include "ObjectReader.h"
 #include "toaster_msgs/IoTData.h"
-
+#include "pdg/utility/OM2MPayload.h"
 
 class OM2MObjectReader : public ObjectReader {
 
@@ -27,8 +27,20 @@ public:
 private:
     void newValueCallBack(const toaster_msgs::IoTData::ConstPtr& msg);
 
-    std::string getSubpart(std::string data, std::string start, std::string stop);
-    vector<struct preFact_t> readPreFacts(MovableObject* object);
+    // Pre facts of each object with the value they were read from, as the
+    // values of all objects are read, whatever their reader
+    struct objectPreFacts_t
+    {
+      std::string value;
+      vector<struct preFact_t> preFacts;
+    };
+    std::map<std::string, objectPreFacts_t> preFacts_;
+
+    std::string topic_;
+
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif //PDG_OM2MOBJECTREADER_H
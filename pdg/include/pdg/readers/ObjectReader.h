@@ -17,6 +17,8 @@
 #include "toaster-lib/MovableObject.h"
 #include "pdg/readers/Reader.h"
 #include "pdg/types.h"
+#include "pdg/utility/ListBuffer.h"
+#include "pdg/utility/EntityLifecycle.h"
 #include <map>
 #include <string>
 #include <unistd.h>
@@ -33,6 +35,13 @@ public:
   virtual void Publish(struct toasterList_t& list_msg) {};
   void Publish(struct toasterList_t& list_msg, struct objectIn_t& objectIn);
 
+  // Object readers share globalLastConfig_, so they share its mutex
+  virtual std::mutex& configMutex() {return lastConfigMutex_; }
+
+  // Times in ns before an object is not present, then before it is forgotten.
+  // Objects are never forgotten by default, as some readers only update them on change.
+  static void setLifecycleTimes(uint64_t staleTime, uint64_t evictTime);
+
   protected:
   ros::Subscriber sub_;
   static unsigned int nbReaders_;
@@ -42,10 +51,12 @@ public:
   bool isPresent(std::string id);
   void increaseNbObjects();
 
-  toaster_msgs::Fact DefaultFactMsg(string id, MovableObject* object, struct objectIn_t& objectIn);
+  void DefaultFactMsg(toaster_msgs::Fact& fact_msg, string id, MovableObject* object, struct objectIn_t& objectIn);
   void putInHand(struct objectIn_t& objectIn, string id, MovableObject* object, struct toasterList_t& list_msg);
 
   static std::mutex lastConfigMutex_;
+  static EntityLifecycle lifecycle_;
+  static bool lifecycleEnabled_;
   static std::vector<ObjectReader*> childs_;
 };
 
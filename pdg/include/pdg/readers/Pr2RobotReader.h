@@ -11,6 +11,7 @@
 #define	PR2ROBOTREADER_H
 
 #include "RobotReader.h"
+#include "pdg/utility/RobotKinematics.h"
 
 #include <ostream>
 #include <tf/transform_listener.h>
@@ -31,8 +32,19 @@ private:
     std::vector<std::string> pr2JointsName_;
     //void initJointsName();
 
+    // With the robot description, only the root link is looked for in tf,
+    // joints are placed from joint_states. Otherwise each joint is looked for.
+    RobotKinematics kinematics_;
+    std::vector<int> jointsLink_;    // kinematics link of each joint, -1 if none
+
+    bool lookupTransform(tf::TransformListener &listener, const std::string& frame, tf::StampedTransform& transform);
+    void setLocation(Entity* entity, const tf::Transform& transform, uint64_t time);
     void setRobotJointLocation(tf::TransformListener &listener, Joint* joint);
     void pr2JointStateCallBack(const sensor_msgs::JointState::ConstPtr& msg);
+
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif /* PR2ROBOTREADER_H */
@@ -14,6 +14,7 @@
 #include <string>
 #include <toaster_msgs/SetEntityPose.h>
 #include <ostream>
+#include <mutex>
 
 #include "pdg/utility/EntityUtility.h"
 
@@ -32,16 +33,48 @@ public:
         node_->getParam(param, activated_);
   }
 
-  void setActivation(bool activated) {activated_ = activated; }
+  // Inputs are only subscribed while the reader is activated
+  void setActivation(bool activated)
+  {
+    if (activated == activated_)
+      return;
+
+    if (activated)
+    {
+      activated_ = true;
+      if (node_ != nullptr)
+        subscribe();
+    }
+    else
+    {
+      if (node_ != nullptr)
+        unsubscribe();
+      activated_ = false;
+    }
+  }
 
   bool activated_;
   ros::NodeHandle* node_;
   std::map<std::string, T*> lastConfig_;
 
+  // Guards lastConfig_ and the entities it points to.
+  // Callbacks update them while holding it, and the publication copies them
+  // into the messages while holding it, so reader callbacks can run on other
+  // threads than the main loop.
+  virtual std::mutex& configMutex() {return configMutex_; }
+
   virtual bool isPresent(std::string id) = 0;
 
   void updateEntityPose(Entity& newPoseEnt, std::string id, Entity* storedEntity);
   void updateEntityPose(Entity& newPoseEnt);
+
+protected:
+  std::mutex configMutex_;
+
+  // Called when the reader is activated or deactivated once initialized.
+  // init calls subscribe if the reader starts activated.
+  virtual void subscribe() {}
+  virtual void unsubscribe() {}
 };
 
 template <typename T>
@@ -58,6 +91,10 @@ void Reader<T>::updateEntityPose(Entity& newPoseEnt, std::string id, Entity* sto
 template <typename T>
 void Reader<T>::updateEntityPose(Entity& newPoseEnt)
 {
+  if(newPoseEnt.getId() == "")
+    return;
+
+  std::lock_guard<std::mutex> lock(configMutex());
   for (typename std::map<std::string, T*>::iterator it = lastConfig_.begin(); it != lastConfig_.end(); ++it)
       updateEntityPose(newPoseEnt, it->first, (Entity*)it->second);
 }
@@ -17,6 +17,7 @@
 #include "toaster-lib/Robot.h"
 #include "pdg/readers/Reader.h"
 #include "pdg/types.h"
+#include "pdg/utility/ListBuffer.h"
 #include <map>
 #include <string>
 
@@ -33,7 +34,7 @@ class RobotReader : public Reader<Robot>{
 
         bool isPresent(std::string id);
 
-        toaster_msgs::Fact DefaultFactMsg(std::string subjectId, uint64_t factTime);
+        void DefaultFactMsg(toaster_msgs::Fact& fact_msg, const std::string& subjectId, uint64_t factTime);
 };
 
 #endif /* ROBOTREADER_H */
@@ -25,6 +25,10 @@ public:
 private:
     void humanJointStateCallBack(const toaster_msgs::HumanListStamped::ConstPtr& msg);
     ros::Subscriber sub_;
+
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif	/* TOASTERSIMUHUMANREADER_H */
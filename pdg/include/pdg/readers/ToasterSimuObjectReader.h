@@ -23,6 +23,10 @@ public:
 private:
     //Functions
     void objectStateCallBack(const toaster_msgs::ObjectListStamped::ConstPtr& msg);
+
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif	/* TOASTERSIMUOBJECTREADER_H */
@@ -22,6 +22,10 @@ public:
 private:
     void robotJointStateCallBack(const toaster_msgs::RobotListStamped::ConstPtr& msg);
     ros::Subscriber sub_;
+
+protected:
+    virtual void subscribe();
+    virtual void unsubscribe();
 };
 
 #endif	/* TOASTERSIMUROBOTREADER_H */
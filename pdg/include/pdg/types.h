@@ -22,12 +22,4 @@ struct fullConfig_t
   bool Robot_ = true; //If false we will use only position and orientation
 };
 
-struct toasterList_t
-{
-  toaster_msgs::ObjectListStamped object_msg;
-  toaster_msgs::HumanListStamped human_msg;
-  toaster_msgs::RobotListStamped robot_msg;
-  toaster_msgs::FactList fact_msg;
-};
-
 #endif
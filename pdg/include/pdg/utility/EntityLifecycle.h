@@ -0,0 +1,60 @@
+/*
+ * File:   EntityLifecycle.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Follows when the entities of a reader appear, disappear and can be forgotten.
+// An entity is live until it is not updated for staleTime, it is then evicted
+// if it is still not updated evictTime later.
+// Deadlines are kept ordered by time, so an update only looks at the entities
+// whose deadline has passed.
+
+#ifndef ENTITYLIFECYCLE_H
+#define	ENTITYLIFECYCLE_H
+
+#include <toaster_msgs/EntityEvent.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+class EntityLifecycle {
+public:
+    EntityLifecycle();
+
+    // Times in ns, an evictTime of 0 never evicts
+    void setTimes(uint64_t staleTime, uint64_t evictTime);
+
+    // Gives the time of the last update of an entity. Nothing is done if it
+    // did not change since the last call.
+    void seen(const std::string& id, uint64_t time, uint64_t now);
+
+    // Marks the entities not updated anymore, and gives the ones to evict
+    void update(uint64_t now, std::vector<std::string>& evicted);
+
+    bool isLive(const std::string& id) const;
+
+    // Appends the appear / disappear events since the last call
+    void takeEvents(std::vector<toaster_msgs::EntityEvent>& events);
+
+private:
+    typedef std::multimap<uint64_t, std::string> deadlines_t;
+
+    struct entity_t {
+        uint64_t time;
+        bool live;
+        deadlines_t::iterator deadline;    // deadlines_.end() if none
+    };
+
+    void addEvent(const std::string& id, unsigned char transition, uint64_t time);
+
+    uint64_t staleTime_;
+    uint64_t evictTime_;
+
+    std::map<std::string, entity_t> entities_;
+    deadlines_t deadlines_;
+    std::vector<toaster_msgs::EntityEvent> events_;
+};
+
+#endif	/* ENTITYLIFECYCLE_H */
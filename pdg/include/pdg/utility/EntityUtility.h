@@ -4,30 +4,53 @@
 #include <toaster_msgs/RobotListStamped.h>
 #include <toaster_msgs/HumanListStamped.h>
 #include <toaster_msgs/ObjectListStamped.h>
-#include <toaster_msgs/SetEntityPose.h>
+#include <toaster_msgs/SetEntitiesPose.h>
 
 #include "toaster-lib/MovableObject.h"
+#include "toaster-lib/Joint.h"
+
+#include "pdg/types.h"
+#include "pdg/utility/ListBuffer.h"
 
 #ifndef ENTITYUTILITY_H
 #define ENTITYUTILITY_H
 
 using namespace std;
 
-// Service client
-void EntityUtility_setClient(ros::ServiceClient* m_setPoseClient);
+// Starts the thread sending the poses to the set_entities_pose service of
+// toaster_simu, and stops it
+void EntityUtility_setClient(ros::NodeHandle* node, const std::string& service);
+void EntityUtility_closeClient();
 
 void fillValue(MovableObject* srcObject, toaster_msgs::Object& msgObject);
 
 void fillEntity(Entity* srcEntity, toaster_msgs::Entity& msgEntity);
 
+// Same as above, computing the quaternion only if the orientation changed since the cache was filled
+void fillEntity(Entity* srcEntity, toaster_msgs::Entity& msgEntity, orientationCache_t& cache);
+
+// Fills the joints of an agent message in place, in the order of the skeleton.
+// If jointPosition is false, the joint positions are set to 0.
+void fillSkeleton(std::map<std::string, Joint*>& skeleton, const std::string& agentId,
+        toaster_msgs::Agent& msgAgent, agentCache_t& cache, bool jointPosition);
+
+// Next message to fill for the current publication of list_msg, see toasterList_t
+toaster_msgs::Fact& nextFactMsg(struct toasterList_t& list_msg);
+toaster_msgs::Object& nextObjectMsg(struct toasterList_t& list_msg, orientationCache_t*& cache);
+toaster_msgs::Human& nextHumanMsg(struct toasterList_t& list_msg, agentCache_t*& cache);
+toaster_msgs::Robot& nextRobotMsg(struct toasterList_t& list_msg, agentCache_t*& cache);
+
 void updateEntity(Entity& newPoseEnt, Entity* storedEntity);
 
+// Queues the pose of the entity, sent to toaster_simu by sendToasterSimu
 bool updateToasterSimu(Entity* storedEntity, string type);
 
-bool putAtJointPosition(Entity* storedEntity, string agentId, string joint,
-        toaster_msgs::HumanListStamped& humanList_msg, bool toastersimu);
+// Gives the queued poses to the sending thread, which sends them to
+// toaster_simu in a single request without blocking the caller
+bool sendToasterSimu();
 
-bool putAtJointPosition(Entity* storedEntity, string agentId, string joint,
-        toaster_msgs::RobotListStamped robotList_msg, bool toastersimu);
+// Puts the entity at the joint of an agent of list_msg, found in its agentIndex
+bool putAtJointPosition(Entity* storedEntity, const string& agentId, const string& joint,
+        struct toasterList_t& list_msg, bool toastersimu);
 
 #endif
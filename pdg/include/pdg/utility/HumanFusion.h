@@ -0,0 +1,77 @@
+/*
+ * File:   HumanFusion.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Fuses the humans published by several human readers.
+// Each track keeps its last two samples, so its position can be interpolated,
+// or shortly extrapolated, to the publication time.
+// Tracks of different sources closer than a gate distance are associated with
+// a greedy nearest neighbour, a track being associated to at most one track of
+// each other source. Pairs associated at the previous publication get a larger
+// gate, so a person keeps its id. Each group of tracks is published as a single
+// human, at the mean position of its tracks.
+
+#ifndef HUMANFUSION_H
+#define	HUMANFUSION_H
+
+#include "pdg/types.h"
+#include "pdg/utility/ListBuffer.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+class HumanFusion {
+public:
+    HumanFusion();
+
+    // Distance in m under which two tracks of different sources are the same person
+    void setGate(double gate) {gate_ = gate; }
+
+    // Longest time in s a position is extrapolated after its last sample
+    void setMaxExtrapolation(double maxExtrapolation) {maxExtrapolation_ = maxExtrapolation; }
+
+    // Fuses the humans of the list, which are sorted by source:
+    // humans of source i end at sourcesEnd[i].
+    // Humans of a group but the one giving its id, and their isPresent facts,
+    // are removed from the list.
+    void fuse(struct toasterList_t& list_msg, const std::vector<unsigned int>& sourcesEnd, uint64_t time);
+
+private:
+    struct sample_t {
+        uint64_t time;
+        double position[3];
+    };
+
+    struct track_t {
+        sample_t last;
+        sample_t prev;
+        bool hasPrev;
+        std::string fusedId;    // id published for this track at the last publication
+    };
+
+    struct pair_t {
+        double cost;
+        unsigned int first;
+        unsigned int second;
+
+        bool operator<(const pair_t& other) const {return cost < other.cost; }
+    };
+
+    void updateTrack(track_t& track, const toaster_msgs::Entity& entity);
+    void position(const track_t& track, uint64_t time, double position[3]) const;
+    unsigned int findGroup(std::vector<unsigned int>& groups, unsigned int i) const;
+
+    // Tracks of a source and an id, as several sources may give the same id
+    typedef std::pair<unsigned int, std::string> trackKey_t;
+
+    double gate_;
+    double maxExtrapolation_;
+
+    std::map<trackKey_t, track_t> tracks_;
+};
+
+#endif	/* HUMANFUSION_H */
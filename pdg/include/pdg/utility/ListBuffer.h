@@ -0,0 +1,87 @@
+/*
+ * File:   ListBuffer.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Messages published by pdg, kept from one publication to the next and filled
+// in place: lists are only resized when the number of entities changes.
+// clear() starts a new publication, and the next*Msg functions of
+// EntityUtility give the messages to fill, in order.
+
+#ifndef LISTBUFFER_H
+#define	LISTBUFFER_H
+
+#include <toaster_msgs/FactList.h>
+#include <toaster_msgs/RobotListStamped.h>
+#include <toaster_msgs/HumanListStamped.h>
+#include <toaster_msgs/ObjectListStamped.h>
+#include <toaster_msgs/EntityEvent.h>
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+// Orientation converted last time for a message, its quaternion is only
+// computed again when the orientation changes
+struct orientationCache_t {
+    double rpy[3] = {NAN, NAN, NAN};
+    geometry_msgs::Quaternion quaternion;
+};
+
+struct agentCache_t {
+    orientationCache_t entity;
+    std::vector<orientationCache_t> joints;
+};
+
+// Agent of the current publication, with the index of its joints by name
+struct agentIndex_t {
+    toaster_msgs::Agent* agent = nullptr;
+    std::vector<std::string> skeletonNames;    // names the joints were indexed from
+    std::map<std::string, unsigned int> joints;
+    unsigned int publication = 0;
+};
+
+struct toasterList_t {
+    toaster_msgs::ObjectListStamped object_msg;
+    toaster_msgs::HumanListStamped human_msg;
+    toaster_msgs::RobotListStamped robot_msg;
+    toaster_msgs::FactList fact_msg;
+
+    // Entities which appeared or disappeared since the last publication
+    std::vector<toaster_msgs::EntityEvent> entityEvents;
+
+    // Number of messages filled in each list for this publication
+    unsigned int nbObjects = 0;
+    unsigned int nbHumans = 0;
+    unsigned int nbRobots = 0;
+    unsigned int nbFacts = 0;
+
+    // Orientations of the messages, same order as the lists
+    std::vector<orientationCache_t> objectCache;
+    std::vector<agentCache_t> humanCache;
+    std::vector<agentCache_t> robotCache;
+
+    // Agents by id, built by finishAgents. Humans come first when a human and a
+    // robot share an id.
+    std::map<std::string, agentIndex_t> agentIndex;
+    unsigned int publication = 0;
+
+    void clear();
+
+    // Removes the agents of the last publication which were not filled again
+    void finishAgents();
+
+    // Gives the joint of an agent of the current publication, agent is null if the agent is unknown
+    // and jointIndex is the size of its skeleton if the joint is unknown
+    void findJoint(const std::string& agentId, const std::string& joint,
+            toaster_msgs::Agent*& agent, unsigned int& jointIndex);
+
+    void finish();
+
+private:
+    void indexAgent(toaster_msgs::Agent& agent);
+};
+
+#endif	/* LISTBUFFER_H */
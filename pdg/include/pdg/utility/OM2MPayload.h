@@ -0,0 +1,52 @@
+/*
+ * File:   OM2MPayload.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Reading of the values sent by OM2M. A value holds one line per field,
+// each line ended by a new line:
+//   NAME=... type=TYPE /data=DATA /unit=UNIT /color=COLOR
+// where NAME is DATA if the type is given by the type field.
+
+#ifndef OM2MPAYLOAD_H
+#define	OM2MPAYLOAD_H
+
+#include <boost/utility/string_ref.hpp>
+#include <string>
+#include <vector>
+
+enum objectType_t
+{
+  sensor,
+  other
+};
+
+struct preFact_t
+{
+  std::string type;
+  std::string data;
+  std::string param;
+  enum objectType_t objectType;
+};
+
+// Fields of a payload line, pointing into the payload
+struct payloadLine_t
+{
+  boost::string_ref name;
+  boost::string_ref type;
+  boost::string_ref data;
+  boost::string_ref unit;
+  boost::string_ref color;
+};
+
+// Reads a line in one pass. The name is before the first '=', and a field
+// is what follows the first occurrence of its key, up to the next " /" or
+// the end of the line.
+// Returns false if the line has no '='.
+bool readPayloadLine(boost::string_ref line, payloadLine_t& fields);
+
+// Replaces preFacts by the pre facts of the lines of content
+void readPreFacts(boost::string_ref content, std::vector<struct preFact_t>& preFacts);
+
+#endif	/* OM2MPAYLOAD_H */
@@ -0,0 +1,81 @@
+/*
+ * File:   RobotKinematics.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Forward kinematics of a robot described by an URDF.
+// The URDF is loaded once and flattened in a chain where each joint comes
+// after the joint of its parent link, so all link poses are computed in one
+// pass from the joint positions of a joint_states message.
+// Poses are given relative to the root link of the URDF.
+
+#ifndef ROBOTKINEMATICS_H
+#define	ROBOTKINEMATICS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <tf/transform_datatypes.h>
+#include "sensor_msgs/JointState.h"
+
+class RobotKinematics {
+public:
+    RobotKinematics();
+
+    // Loads the URDF from the parameter server
+    bool load(const std::string& param);
+
+    bool isLoaded() const {return loaded_; }
+
+    const std::string& rootLink() const {return rootLink_; }
+
+    // Index of a link, -1 if the URDF does not have it
+    int linkIndex(const std::string& link) const;
+
+    // Stores the joint positions of a message. The index of each name is
+    // only looked for again when the names of the messages change.
+    void setJointPositions(const sensor_msgs::JointState& msg);
+
+    // Computes the pose of every link from the stored joint positions
+    void update();
+
+    const tf::Transform& linkPose(int index) const {return links_[index]; }
+
+private:
+    enum jointType_t {
+        FIXED,
+        REVOLUTE,
+        PRISMATIC
+    };
+
+    struct chainJoint_t {
+        int parent;     // link indexes
+        int child;
+        tf::Transform origin;
+        tf::Vector3 axis;
+        jointType_t type;
+
+        // position of another joint if this one mimics it
+        int mimic;
+        double multiplier;
+        double offset;
+    };
+
+    bool loaded_;
+    std::string rootLink_;
+
+    std::vector<chainJoint_t> chain_;
+    std::map<std::string, int> jointIndex_;
+    std::map<std::string, int> linkIndex_;
+
+    std::vector<double> positions_;
+    std::vector<tf::Transform> links_;
+
+    // Chain index of each name of the last message, -1 if not in the chain
+    std::vector<std::string> msgNames_;
+    std::vector<int> msgIndex_;
+};
+
+#endif	/* ROBOTKINEMATICS_H */
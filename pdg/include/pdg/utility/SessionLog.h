@@ -0,0 +1,152 @@
+/*
+ * File:   SessionLog.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Binary log of a session of pdg outputs, written by pdg_recorder and read by
+// pdg_replayer.
+// The file holds one record per recorded message, then the table of the
+// strings used by the frames and the index of the frames:
+//   fileHeader_t | records | strings | frameIndex_t[nbFrames]
+// A record holds the strings first used by its frame, its frameIndex_t and
+// the frame. Inside a frame, each field of the entities is stored as a
+// column, 8 bytes aligned, strings being replaced by their index in the table.
+// A frame is read directly from the mapped file.
+// The table and the index are written when the log is closed. If the recorder
+// was stopped before, they are rebuilt by reading the records.
+// Only the fields filled by pdg are recorded: inArea and the objects relations
+// are replayed empty.
+
+#ifndef SESSIONLOG_H
+#define	SESSIONLOG_H
+
+#include <toaster_msgs/HumanListStamped.h>
+#include <toaster_msgs/RobotListStamped.h>
+#include <toaster_msgs/ObjectListStamped.h>
+#include <toaster_msgs/FactList.h>
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace sessionLog {
+
+    enum stream_t {
+        HUMANS = 0,
+        ROBOTS = 1,
+        OBJECTS = 2,
+        FACTS = 3
+    };
+
+    struct fileHeader_t {
+        char magic[8];
+        uint32_t version;
+        uint32_t nbFrames;
+        uint64_t stringsOffset;
+        uint64_t indexOffset;   // 0 until the log is closed
+    };
+
+    struct frameIndex_t {
+        uint64_t stamp;         // ns, header stamp or reception time for facts
+        uint64_t offset;
+        uint64_t size;
+        uint32_t seq;
+        uint32_t frameId;       // string index
+        uint32_t count;         // number of entities or facts
+        uint32_t stream;
+    };
+
+    class Writer {
+    public:
+        Writer();
+        ~Writer();
+
+        bool open(const std::string& path);
+
+        // Writes the strings and the index
+        void close();
+
+        // Writes the buffered records, which can be read if the recorder stops
+        void flush();
+
+        void write(const toaster_msgs::HumanListStamped& msg);
+        void write(const toaster_msgs::RobotListStamped& msg);
+        void write(const toaster_msgs::ObjectListStamped& msg);
+        void write(const toaster_msgs::FactList& msg, uint64_t stamp);
+
+        unsigned int nbFrames() const {return index_.size(); }
+
+    private:
+        uint32_t stringIndex(const std::string& str);
+
+        template <typename T>
+        void column(const std::vector<T>& values);
+
+        void strings(unsigned int first);
+        void entities(const std::vector<const toaster_msgs::Entity*>& entities);
+        void agents(const std::vector<const toaster_msgs::Agent*>& agents);
+        void writeFrame(uint32_t stream, const std_msgs::Header& header, uint32_t count);
+
+        FILE* file_;
+        uint64_t offset_;
+        std::vector<char> frame_;
+        std::vector<char> record_;
+        unsigned int nbWrittenStrings_;
+        std::vector<frameIndex_t> index_;
+        std::map<std::string, uint32_t> stringIds_;
+        std::vector<const std::string*> strings_;
+    };
+
+    class Reader {
+    public:
+        Reader();
+        ~Reader();
+
+        bool open(const std::string& path);
+        void close();
+
+        unsigned int nbFrames() const {return nbFrames_; }
+        const frameIndex_t& frame(unsigned int i) const {return index_[i]; }
+
+        // Fill the message of frame i, which must be of the same stream
+        // Return false if the frame is corrupted
+        bool read(unsigned int i, toaster_msgs::HumanListStamped& msg) const;
+        bool read(unsigned int i, toaster_msgs::RobotListStamped& msg) const;
+        bool read(unsigned int i, toaster_msgs::ObjectListStamped& msg) const;
+        bool read(unsigned int i, toaster_msgs::FactList& msg) const;
+
+    private:
+        // Reads the columns of a frame in order. A column going past end
+        // gives NULL, and so do the following ones.
+        struct cursor_t {
+            const char* ptr;
+            const char* end;
+
+            template <typename T>
+            const T* column(uint64_t size);
+        };
+
+        bool readStrings(cursor_t& cursor);
+        bool readIndex(const fileHeader_t& header);
+        void scan();
+        bool validFrame(const frameIndex_t& frame, uint64_t end) const;
+        bool validIds(const uint32_t* ids, uint64_t size) const;
+
+        void header(unsigned int i, std_msgs::Header& header) const;
+        cursor_t frameCursor(unsigned int i) const;
+        bool entities(cursor_t& cursor, std::vector<toaster_msgs::Entity*>& entities) const;
+        bool agents(cursor_t& cursor, std::vector<toaster_msgs::Agent*>& agents) const;
+
+        const char* data_;
+        size_t size_;
+        unsigned int nbFrames_;
+        const frameIndex_t* index_;
+        std::vector<frameIndex_t> scannedIndex_;
+        std::vector<std::string> strings_;
+    };
+}
+
+#endif	/* SESSIONLOG_H */
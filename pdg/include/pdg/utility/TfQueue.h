@@ -0,0 +1,111 @@
+/*
+ * File:   TfQueue.h
+ *
+ * Created on October 19, 2026
+ */
+
+// Holds stamped messages until the transform from their frame to a target
+// frame is available, without ever waiting on tf.
+// Messages are checked when they arrive and by a timer. Ready messages are
+// given to the callback in their arrival order, messages still waiting after
+// the timeout or pushed out of a full queue are dropped.
+
+#ifndef TFQUEUE_H
+#define	TFQUEUE_H
+
+#include <ros/ros.h>
+#include <tf/transform_listener.h>
+#include <boost/function.hpp>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+template <typename M>
+class TfQueue {
+public:
+    typedef boost::shared_ptr<const M> MConstPtr;
+    typedef boost::function<void(const MConstPtr&)> callback_t;
+
+    TfQueue() {listener_ = nullptr; timeout_ = ros::Duration(3.0); queueSize_ = 10; }
+
+    // The timer runs on the callback queue of node
+    void init(ros::NodeHandle* node, tf::TransformListener* listener, const std::string& targetFrame, callback_t callback)
+    {
+        listener_ = listener;
+        targetFrame_ = targetFrame;
+        callback_ = callback;
+        timer_ = node->createTimer(ros::Duration(0.05), &TfQueue::timerCallback, this);
+    }
+
+    // Stops the timer and drops the waiting messages, until start
+    void stop()
+    {
+        timer_.stop();
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.clear();
+    }
+
+    void start() {timer_.start(); }
+
+    void setTimeout(double timeout) {timeout_ = ros::Duration(timeout); }
+    void setQueueSize(unsigned int queueSize) {queueSize_ = queueSize; }
+
+    void add(const MConstPtr& msg)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back(msg);
+            if (pending_.size() > queueSize_) {
+                ROS_WARN_THROTTLE(5.0, "[PDG] no transform from %s to %s, dropping messages",
+                        pending_.front()->header.frame_id.c_str(), targetFrame_.c_str());
+                pending_.pop_front();
+            }
+        }
+        process();
+    }
+
+    // The timer and add may run on different threads: messages are taken and
+    // delivered under deliveryMutex_, so that they stay in arrival order
+    void process()
+    {
+        std::lock_guard<std::mutex> deliveryLock(deliveryMutex_);
+        std::vector<MConstPtr> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ros::Time now = ros::Time::now();
+            typename std::deque<MConstPtr>::iterator it = pending_.begin();
+            while (it != pending_.end()) {
+                if (listener_->canTransform(targetFrame_, (*it)->header.frame_id, (*it)->header.stamp)) {
+                    ready.push_back(*it);
+                    it = pending_.erase(it);
+                } else if (now - (*it)->header.stamp > timeout_) {
+                    ROS_WARN_THROTTLE(5.0, "[PDG] no transform from %s to %s after %f s, dropping message",
+                            (*it)->header.frame_id.c_str(), targetFrame_.c_str(), timeout_.toSec());
+                    it = pending_.erase(it);
+                } else
+                    ++it;
+            }
+        }
+
+        for (unsigned int i = 0; i < ready.size(); i++)
+            callback_(ready[i]);
+    }
+
+private:
+    void timerCallback(const ros::TimerEvent&) {process(); }
+
+    tf::TransformListener* listener_;
+    std::string targetFrame_;
+    callback_t callback_;
+    ros::Timer timer_;
+
+    ros::Duration timeout_;
+    unsigned int queueSize_;
+
+    std::mutex deliveryMutex_;
+    std::mutex mutex_;
+    std::deque<MConstPtr> pending_;
+};
+
+#endif	/* TFQUEUE_H */
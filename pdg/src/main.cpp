@@ -11,8 +11,12 @@
 //tf
 #include <tf/transform_broadcaster.h>
 
+#include <ros/callback_queue.h>
+#include <boost/make_shared.hpp>
+
 //Utility
 #include "pdg/utility/EntityUtility.h"
+#include "pdg/utility/HumanFusion.h"
 
 #include "pdg/readers/MorseHumanReader.h"
 #include "pdg/readers/MocapHumanReader.h"
@@ -30,6 +34,7 @@
 #include "pdg/readers/OM2MObjectReader.h"
 
 #include "pdg/types.h"
+#include "pdg/utility/ListBuffer.h"
 
 struct fullConfig_t fullConfig;
 
@@ -163,23 +168,161 @@ bool setEntityPose(toaster_msgs::SetEntityPose::Request &req,
 //////////////////
 // TF broadcast //
 //////////////////
-void broadcastTfEntity(tf::TransformBroadcaster &tf_br,toaster_msgs::Entity &entity,const std::string &prefix,ros::Time &stamp){
-    geometry_msgs::Pose &pose=entity.pose;
-    tf::Transform transform;
-    transform.setOrigin(tf::Vector3(pose.position.x,pose.position.y,pose.position.z));
-    transform.setRotation(tf::Quaternion(pose.orientation.x,pose.orientation.y,pose.orientation.z,pose.orientation.w));
-    tf_br.sendTransform(tf::StampedTransform(transform,stamp,"map",prefix+"/"+entity.id));
+// Transforms of one loop, sent to tf in a single message.
+// Frame names are built once per entity and kept while the entity is sent,
+// transforms are filled in place.
+
+// Frame name of an entity, and the last batch it was sent in
+struct tfFrame_t {
+    std::string name;
+    unsigned int batch = 0;
+};
+
+struct tfBatch_t {
+    std::vector<geometry_msgs::TransformStamped> transforms;
+    unsigned int nbTransforms = 0;
+    unsigned int batch = 1;
+    bool joints = false;
+
+    // frames of the objects ("/id"), of the agents ("id/base") and of the joints of each agent
+    std::map<std::string, tfFrame_t> objectFrames;
+    std::map<std::string, tfFrame_t> agentFrames;
+    std::map<std::string, std::map<std::string, tfFrame_t> > jointFrames;
+};
+
+std::string &frameName(std::map<std::string, tfFrame_t> &frames, const std::string &id, unsigned int batch){
+    tfFrame_t &frame = frames[id];
+    frame.batch = batch;
+    return frame.name;
+}
+
+void removeOldFrames(std::map<std::string, tfFrame_t> &frames, unsigned int batch){
+    for (std::map<std::string, tfFrame_t>::iterator it = frames.begin(); it != frames.end();) {
+        if (it->second.batch != batch)
+            frames.erase(it++);
+        else
+            ++it;
+    }
+}
+
+void addTransform(tfBatch_t &batch, const geometry_msgs::Pose &pose, const std::string &frame, const ros::Time &stamp){
+    if (batch.nbTransforms == batch.transforms.size()) {
+        batch.transforms.push_back(geometry_msgs::TransformStamped());
+        batch.transforms.back().header.frame_id = "map";
+    }
+    geometry_msgs::TransformStamped &transform = batch.transforms[batch.nbTransforms++];
+    transform.header.stamp = stamp;
+    if (transform.child_frame_id != frame)
+        transform.child_frame_id = frame;
+    transform.transform.translation.x = pose.position.x;
+    transform.transform.translation.y = pose.position.y;
+    transform.transform.translation.z = pose.position.z;
+    transform.transform.rotation = pose.orientation;
 }
-void broadcastTfAgent(tf::TransformBroadcaster &tf_br,toaster_msgs::Agent &agent,const std::string &prefix,ros::Time &stamp){
-    geometry_msgs::Pose &pose=agent.meEntity.pose;
-    tf::Transform transform;
-    transform.setOrigin(tf::Vector3(pose.position.x,pose.position.y,pose.position.z));
-    transform.setRotation(tf::Quaternion(pose.orientation.x,pose.orientation.y,pose.orientation.z,pose.orientation.w));
-    tf_br.sendTransform(tf::StampedTransform(transform,stamp,"map",prefix+agent.meEntity.id+"/base"));
 
+void broadcastTfEntity(tfBatch_t &batch,toaster_msgs::Entity &entity,ros::Time &stamp){
+    std::string &frame = frameName(batch.objectFrames, entity.id, batch.batch);
+    if (frame.empty())
+        frame = "/" + entity.id;
+    addTransform(batch, entity.pose, frame, stamp);
+}
+
+void broadcastTfAgent(tfBatch_t &batch,toaster_msgs::Agent &agent,ros::Time &stamp, bool joints){
+    std::string &frame = frameName(batch.agentFrames, agent.meEntity.id, batch.batch);
+    if (frame.empty())
+        frame = agent.meEntity.id + "/base";
+    addTransform(batch, agent.meEntity.pose, frame, stamp);
+
+    if (!joints)
+        return;
+    batch.joints = true;
+    if (agent.skeletonJoint.empty())
+        return;
+
+    std::map<std::string, tfFrame_t> &jointFrames = batch.jointFrames[agent.meEntity.id];
     for(uint i_jnt=0;i_jnt<agent.skeletonJoint.size();++i_jnt){
-        broadcastTfEntity(tf_br,agent.skeletonJoint[i_jnt].meEntity,prefix+"/"+agent.meEntity.id,stamp);
+        toaster_msgs::Entity &joint = agent.skeletonJoint[i_jnt].meEntity;
+        std::string &jointFrame = frameName(jointFrames, joint.id, batch.batch);
+        if (jointFrame.empty())
+            jointFrame = "/" + agent.meEntity.id + "/" + joint.id;
+        addTransform(batch, joint.pose, jointFrame, stamp);
+    }
+}
+
+// Sends the batch, and removes the frames of the entities which were not in it.
+// Joints are only checked when they were sent.
+void sendTf(tf::TransformBroadcaster &tf_br, tfBatch_t &batch){
+    batch.transforms.resize(batch.nbTransforms);
+    if (!batch.transforms.empty())
+        tf_br.sendTransform(batch.transforms);
+    batch.nbTransforms = 0;
+
+    removeOldFrames(batch.objectFrames, batch.batch);
+    removeOldFrames(batch.agentFrames, batch.batch);
+    typedef std::map<std::string, std::map<std::string, tfFrame_t> >::iterator jointFramesIt;
+    for (jointFramesIt it = batch.jointFrames.begin(); it != batch.jointFrames.end();) {
+        if (batch.agentFrames.find(it->first) == batch.agentFrames.end()) {
+            batch.jointFrames.erase(it++);
+            continue;
+        }
+        if (batch.joints)
+            removeOldFrames(it->second, batch.batch);
+        ++it;
     }
+    batch.joints = false;
+    batch.batch++;
+}
+
+////////////////////
+// Output rates   //
+////////////////////
+// Each output is published at its own rate, decimated from the loop which
+// runs at the highest of them.
+struct outputRate_t {
+    ros::Duration period;
+    ros::Time next;
+};
+
+void initOutputRate(outputRate_t &output, ros::NodeHandle &node, const std::string &param, double &loopRate){
+    double rate = 30.0;
+    node.getParam(param, rate);
+    if (rate <= 0.0) {
+        ROS_WARN("[PDG] %s should be positive, using 30 Hz", param.c_str());
+        rate = 30.0;
+    }
+    output.period = ros::Duration(1.0 / rate);
+    loopRate = std::max(loopRate, rate);
+}
+
+// A loop slightly early still publishes, so an output at the loop rate never skips a loop
+bool outputDue(outputRate_t &output, const ros::Time &now, const ros::Duration &tolerance){
+    if (now + tolerance < output.next)
+        return false;
+    output.next += output.period;
+    if (output.next < now)
+        output.next = now + output.period;
+    return true;
+}
+
+// An object list is changed if an object appeared, disappeared, moved or changed its value
+bool objectsChanged(const toaster_msgs::ObjectListStamped &last, const toaster_msgs::ObjectListStamped &current){
+    if (last.objectList.size() != current.objectList.size())
+        return true;
+    for (unsigned int i = 0; i < current.objectList.size(); i++) {
+        const toaster_msgs::Object &lastObject = last.objectList[i];
+        const toaster_msgs::Object &object = current.objectList[i];
+        if (lastObject.meEntity.id != object.meEntity.id
+                || lastObject.meEntity.pose.position.x != object.meEntity.pose.position.x
+                || lastObject.meEntity.pose.position.y != object.meEntity.pose.position.y
+                || lastObject.meEntity.pose.position.z != object.meEntity.pose.position.z
+                || lastObject.meEntity.pose.orientation.x != object.meEntity.pose.orientation.x
+                || lastObject.meEntity.pose.orientation.y != object.meEntity.pose.orientation.y
+                || lastObject.meEntity.pose.orientation.z != object.meEntity.pose.orientation.z
+                || lastObject.meEntity.pose.orientation.w != object.meEntity.pose.orientation.w
+                || lastObject.value != object.value)
+            return true;
+    }
+    return false;
 }
 
 int main(int argc, char** argv) {
@@ -188,39 +331,75 @@ int main(int argc, char** argv) {
     ros::NodeHandle node;
 
     tf::TransformBroadcaster tf_br;
+    tfBatch_t tfBatch;
+
+    // With /pdg/tfJointRate (Hz), joints frames are broadcast at a lower rate
+    // than the entities and agents frames. 0 broadcasts them every loop.
+    double tfJointRate = 0.0;
+    node.getParam("/pdg/tfJointRate", tfJointRate);
+    ros::Duration tfJointPeriod(tfJointRate > 0.0 ? 1.0 / tfJointRate : 0.0);
+    ros::Time lastTfJoints;
+
+    // With /pdg/readerThreads, readers callbacks are spun by their own threads
+    // instead of the main loop, so a high rate input does not wait for publication.
+    int readerThreads = 0;
+    node.getParam("/pdg/readerThreads", readerThreads);
+    ros::NodeHandle readerNode;
+    ros::CallbackQueue readerQueue;
+    if (readerThreads > 0)
+        readerNode.setCallbackQueue(&readerQueue);
 
     //Data reading
     vector<HumanReader*> humanReaders;
-    groupHumanRd.init(&node, "/spencer/perception/tracked_groups", "/pdg/groupHuman");
+    groupHumanRd.init(&readerNode, "/spencer/perception/tracked_groups", "/pdg/groupHuman");
     humanReaders.push_back(&groupHumanRd);
-    morseHumanRd.init(&node, "/pdg/morseHuman");
+    morseHumanRd.init(&readerNode, "/pdg/morseHuman");
     humanReaders.push_back(&morseHumanRd);
     //niutHumanRd.init(&node, "/niut/Human", "/pdg/niutHuman")
-    mocapHumanRd.init(&node, "/optitrack_person/tracked_persons", "/pdg/mocapHuman");
+    mocapHumanRd.init(&readerNode, "/optitrack_person/tracked_persons", "/pdg/mocapHuman");
     humanReaders.push_back(&mocapHumanRd);
-    adreamMocapHumanRd.init(&node, "/optitrack/bodies/Rigid_Body_3", "/optitrack/bodies/Rigid_Body_1", "/optitrack/bodies/Rigid_Body_2", "/pdg/adreamMocapHuman");
+    adreamMocapHumanRd.init(&readerNode, "/optitrack/bodies/Rigid_Body_3", "/optitrack/bodies/Rigid_Body_1", "/optitrack/bodies/Rigid_Body_2", "/pdg/adreamMocapHuman");
     humanReaders.push_back(&adreamMocapHumanRd);
-    toasterSimuHumanRd.init(&node, "/pdg/toasterSimuHuman");
+    toasterSimuHumanRd.init(&readerNode, "/pdg/toasterSimuHuman");
     humanReaders.push_back(&toasterSimuHumanRd);
 
     vector<RobotReader*> robotReaders;
-    pr2RobotRd.init(&node, "/pdg/pr2Robot");
+    pr2RobotRd.init(&readerNode, "/pdg/pr2Robot");
     robotReaders.push_back(&pr2RobotRd);
-    spencerRobotRd.init(&node, "/pdg/spencerRobot");
+    spencerRobotRd.init(&readerNode, "/pdg/spencerRobot");
     robotReaders.push_back(&spencerRobotRd);
-    toasterSimuRobotRd.init(&node, "/pdg/toasterSimuRobot");
+    toasterSimuRobotRd.init(&readerNode, "/pdg/toasterSimuRobot");
     robotReaders.push_back(&toasterSimuRobotRd);
 
     vector<ObjectReader*> objectReaders;
-    arObjectRd.init(&node, "ar_visualization_marker", "/pdg/arObjectReader");
+    arObjectRd.init(&readerNode, "ar_visualization_marker", "/pdg/arObjectReader");
     objectReaders.push_back(&arObjectRd);
-    om2mObjectRd.init(&node, "/iot2pdg_updates", "/pdg/OM2MObjectReader");
+    om2mObjectRd.init(&readerNode, "/iot2pdg_updates", "/pdg/OM2MObjectReader");
     objectReaders.push_back(&om2mObjectRd);
-    gazeboRd.init(&node, "/gazebo/model_states", "/pdg/gazeboObjectReader");
+    gazeboRd.init(&readerNode, "/gazebo/model_states", "/pdg/gazeboObjectReader");
     objectReaders.push_back(&gazeboRd);
-    toasterSimuObjectRd.init(&node, "/pdg/toasterSimuObject");
+    toasterSimuObjectRd.init(&readerNode, "/pdg/toasterSimuObject");
     objectReaders.push_back(&toasterSimuObjectRd);
 
+    // Entities not updated for staleTime (s) are not present anymore, and are
+    // forgotten evictTime (s) later. Objects are kept unless objectEvictTime is set.
+    double staleTime = 1.0, evictTime = 60.0, objectEvictTime = 0.0;
+    node.getParam("/pdg/staleTime", staleTime);
+    node.getParam("/pdg/evictTime", evictTime);
+    node.getParam("/pdg/objectEvictTime", objectEvictTime);
+    for(vector<HumanReader*>::iterator it = humanReaders.begin(); it != humanReaders.end(); ++it)
+      (*it)->setLifecycleTimes(staleTime * 1e9, evictTime * 1e9);
+    ObjectReader::setLifecycleTimes(staleTime * 1e9, objectEvictTime * 1e9);
+
+    // With /pdg/humanFusion, a person seen by several human readers is published once
+    bool humanFusion = false;
+    double fusionGate = 0.5;
+    node.getParam("/pdg/humanFusion", humanFusion);
+    node.getParam("/pdg/fusionGate", fusionGate);
+    HumanFusion fusion;
+    fusion.setGate(fusionGate);
+    std::vector<unsigned int> humanSourcesEnd(humanReaders.size());
+
     //Services
     ros::ServiceServer addStreamServ = node.advertiseService("pdg/manage_stream", addStream);
     ROS_INFO("Ready to manage stream.");
@@ -234,23 +413,51 @@ int main(int argc, char** argv) {
     ros::ServiceServer setEntPose = node.advertiseService("pdg/set_entity_pose", setEntityPose);
     ROS_INFO("Ready to set Entity position.");
 
+    // Rates in Hz of each output, 30 by default. With /pdg/objectOnChange, the
+    // object list is only published when it changes, at most at /pdg/objectRate,
+    // and is latched for late subscribers.
+    double loopRate = 0.0;
+    outputRate_t humanRate, robotRate, objectRate, factRate, tfRate;
+    initOutputRate(humanRate, node, "/pdg/humanRate", loopRate);
+    initOutputRate(robotRate, node, "/pdg/robotRate", loopRate);
+    initOutputRate(objectRate, node, "/pdg/objectRate", loopRate);
+    initOutputRate(factRate, node, "/pdg/factRate", loopRate);
+    initOutputRate(tfRate, node, "/pdg/tfRate", loopRate);
+    ros::Duration rateTolerance(0.5 / loopRate);
+
+    bool objectOnChange = false;
+    node.getParam("/pdg/objectOnChange", objectOnChange);
+    boost::shared_ptr<toaster_msgs::ObjectListStamped> lastObjects;
+
     //Data writing
-    ros::Publisher object_pub = node.advertise<toaster_msgs::ObjectListStamped>("pdg/objectList", 1000);
+    ros::Publisher object_pub = node.advertise<toaster_msgs::ObjectListStamped>("pdg/objectList", 1000, objectOnChange);
     ros::Publisher human_pub = node.advertise<toaster_msgs::HumanListStamped>("pdg/humanList", 1000);
     ros::Publisher robot_pub = node.advertise<toaster_msgs::RobotListStamped>("pdg/robotList", 1000);
     ros::Publisher fact_pub = node.advertise<toaster_msgs::FactList>("pdg/factList", 1000);
+    ros::Publisher entityEvent_pub = node.advertise<toaster_msgs::EntityEvent>("pdg/entityEvent", 1000);
 
-    ros::ServiceClient setPoseClient = node.serviceClient<toaster_msgs::SetEntityPose>("/toaster_simu/set_entity_pose", true);
-    EntityUtility_setClient(&setPoseClient);
+    EntityUtility_setClient(&node, "/toaster_simu/set_entities_pose");
 
-    ros::Rate loop_rate(30);
+    ros::AsyncSpinner readerSpinner(readerThreads > 0 ? readerThreads : 1, &readerQueue);
+    if (readerThreads > 0)
+        readerSpinner.start();
+
+    ros::Rate loop_rate(loopRate);
 
     tf::TransformListener listener;
     ROS_INFO("[PDG] initializing\n");
 
 
+    // Messages are filled in place from one loop to the next. They are published
+    // as shared pointers, so subscribers in the same process get them without
+    // serialization: if one of them still holds the last list, we work on a copy.
+    boost::shared_ptr<toasterList_t> listPtr = boost::make_shared<toasterList_t>();
+
     while (node.ok()) {
-      toasterList_t list_msg;
+      if (!listPtr.unique())
+        listPtr = boost::make_shared<toasterList_t>(*listPtr);
+      toasterList_t& list_msg = *listPtr;
+      list_msg.clear();
 
         //update data
         morseHumanRd.updateHumans(listener);
@@ -264,59 +471,92 @@ int main(int argc, char** argv) {
         // publish data //
         //////////////////
 
-        for(vector<HumanReader*>::iterator it = humanReaders.begin(); it != humanReaders.end(); ++it)
+        for(unsigned int i = 0; i < humanReaders.size(); i++)
         {
-          (*it)->updateEntityPose(newPoseEnt_);
-          (*it)->Publish(list_msg);
+          humanReaders[i]->updateEntityPose(newPoseEnt_);
+          humanReaders[i]->Publish(list_msg);
+          humanSourcesEnd[i] = list_msg.nbHumans;
         }
 
+        if (humanFusion)
+          fusion.fuse(list_msg, humanSourcesEnd, ros::Time::now().toNSec());
+
         for(vector<RobotReader*>::iterator it = robotReaders.begin(); it != robotReaders.end(); ++it)
         {
           (*it)->updateEntityPose(newPoseEnt_);
           (*it)->Publish(list_msg);
         }
 
+        // agents are complete, objects in hand can look for their joints
+        list_msg.finishAgents();
+
         for(vector<ObjectReader*>::iterator it = objectReaders.begin(); it != objectReaders.end(); ++it)
           (*it)->updateEntityPose(newPoseEnt_);
 
         //do publication for all objects
         ObjectReader tmp;
         tmp.Publish(list_msg, objectIn);
+        list_msg.finish();
+
+        // Objects in hand moved during this publication
+        sendToasterSimu();
 
         ////////////////////////////////////////////////////////////////////////
 
         //header of messages
         seq++;
-        list_msg.object_msg.header.stamp = ros::Time::now();
+        ros::Time now = ros::Time::now();
+        list_msg.object_msg.header.stamp = now;
         list_msg.object_msg.header.seq = seq;
         list_msg.object_msg.header.frame_id = "/map";
 
         list_msg.human_msg.header = list_msg.object_msg.header;
         list_msg.robot_msg.header = list_msg.object_msg.header;
 
-        for(typeof(list_msg.object_msg.objectList.begin()) it=list_msg.object_msg.objectList.begin(); it!= list_msg.object_msg.objectList.end();++it){
-            broadcastTfEntity(tf_br,it->meEntity,"",list_msg.object_msg.header.stamp);
-        }
-
-        for(typeof(list_msg.human_msg.humanList.begin()) it=list_msg.human_msg.humanList.begin(); it!= list_msg.human_msg.humanList.end();++it){
-            broadcastTfAgent(tf_br,it->meAgent,"",list_msg.human_msg.header.stamp);
-        }
-        for(typeof(list_msg.robot_msg.robotList.begin()) it=list_msg.robot_msg.robotList.begin(); it!= list_msg.robot_msg.robotList.end();++it){
-            broadcastTfAgent(tf_br,it->meAgent,"",list_msg.robot_msg.header.stamp);
+        if (outputDue(tfRate, now, rateTolerance)) {
+            bool tfJoints = tfJointPeriod.isZero() || now - lastTfJoints >= tfJointPeriod;
+            if (tfJoints)
+                lastTfJoints = now;
+
+            for(typeof(list_msg.object_msg.objectList.begin()) it=list_msg.object_msg.objectList.begin(); it!= list_msg.object_msg.objectList.end();++it){
+                broadcastTfEntity(tfBatch,it->meEntity,list_msg.object_msg.header.stamp);
+            }
+
+            for(typeof(list_msg.human_msg.humanList.begin()) it=list_msg.human_msg.humanList.begin(); it!= list_msg.human_msg.humanList.end();++it){
+                broadcastTfAgent(tfBatch,it->meAgent,list_msg.human_msg.header.stamp,tfJoints);
+            }
+            for(typeof(list_msg.robot_msg.robotList.begin()) it=list_msg.robot_msg.robotList.begin(); it!= list_msg.robot_msg.robotList.end();++it){
+                broadcastTfAgent(tfBatch,it->meAgent,list_msg.robot_msg.header.stamp,tfJoints);
+            }
+            sendTf(tf_br, tfBatch);
         }
 
 
         //ROS_INFO("%s", msg.data.c_str());
 
-        object_pub.publish(list_msg.object_msg);
-        human_pub.publish(list_msg.human_msg);
-        robot_pub.publish(list_msg.robot_msg);
-        fact_pub.publish(list_msg.fact_msg);
+        if (outputDue(objectRate, now, rateTolerance)) {
+            // The latched list is a copy, so the publisher does not hold list_msg
+            if (!objectOnChange)
+                object_pub.publish(boost::shared_ptr<toaster_msgs::ObjectListStamped>(listPtr, &list_msg.object_msg));
+            else if (!lastObjects || objectsChanged(*lastObjects, list_msg.object_msg)) {
+                lastObjects = boost::make_shared<toaster_msgs::ObjectListStamped>(list_msg.object_msg);
+                object_pub.publish(lastObjects);
+            }
+        }
+        if (outputDue(humanRate, now, rateTolerance))
+            human_pub.publish(boost::shared_ptr<toaster_msgs::HumanListStamped>(listPtr, &list_msg.human_msg));
+        if (outputDue(robotRate, now, rateTolerance))
+            robot_pub.publish(boost::shared_ptr<toaster_msgs::RobotListStamped>(listPtr, &list_msg.robot_msg));
+        if (outputDue(factRate, now, rateTolerance))
+            fact_pub.publish(boost::shared_ptr<toaster_msgs::FactList>(listPtr, &list_msg.fact_msg));
+        for (unsigned int i = 0; i < list_msg.entityEvents.size(); i++)
+          entityEvent_pub.publish(list_msg.entityEvents[i]);
 
         ros::spinOnce();
 
         loop_rate.sleep();
 
     }
+    EntityUtility_closeClient();
     return 0;
 }
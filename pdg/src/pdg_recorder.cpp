@@ -0,0 +1,59 @@
+// Records the lists published by pdg in a session log, see SessionLog.h
+// Topics are the ones of pdg, they can be remapped to record another node.
+
+#include "ros/ros.h"
+
+#include "pdg/utility/SessionLog.h"
+
+sessionLog::Writer writer;
+
+void humanListCallback(const toaster_msgs::HumanListStamped::ConstPtr& msg) {
+    writer.write(*msg);
+}
+
+void robotListCallback(const toaster_msgs::RobotListStamped::ConstPtr& msg) {
+    writer.write(*msg);
+}
+
+void objectListCallback(const toaster_msgs::ObjectListStamped::ConstPtr& msg) {
+    writer.write(*msg);
+}
+
+// Fact lists have no header, they are stamped when received
+void factListCallback(const toaster_msgs::FactList::ConstPtr& msg) {
+    writer.write(*msg, ros::Time::now().toNSec());
+}
+
+// Frames written before are kept if the recorder is killed
+void flushCallback(const ros::WallTimerEvent&) {
+    writer.flush();
+}
+
+int main(int argc, char** argv) {
+    ros::init(argc, argv, "pdg_recorder");
+    ros::NodeHandle node;
+    ros::NodeHandle privateNode("~");
+
+    std::string path = "pdg_session.tlog";
+    double flushPeriod = 1.0;
+    privateNode.getParam("file", path);
+    privateNode.getParam("flush_period", flushPeriod);
+    if (!writer.open(path))
+        return 1;
+
+    // Callbacks are called in order by a single thread, so frames are written in reception order
+    ros::Subscriber humanSub = node.subscribe("pdg/humanList", 1000, humanListCallback);
+    ros::Subscriber robotSub = node.subscribe("pdg/robotList", 1000, robotListCallback);
+    ros::Subscriber objectSub = node.subscribe("pdg/objectList", 1000, objectListCallback);
+    ros::Subscriber factSub = node.subscribe("pdg/factList", 1000, factListCallback);
+    ros::WallTimer flushTimer;
+    if (flushPeriod > 0.0)
+        flushTimer = node.createWallTimer(ros::WallDuration(flushPeriod), flushCallback);
+    ROS_INFO("[pdg_recorder] recording in %s", path.c_str());
+
+    ros::spin();
+
+    ROS_INFO("[pdg_recorder] %u frames recorded in %s", writer.nbFrames(), path.c_str());
+    writer.close();
+    return 0;
+}
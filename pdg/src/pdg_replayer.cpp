@@ -0,0 +1,139 @@
+// Publishes a session log recorded by pdg_recorder on the pdg topics.
+// Frames are published in their recorded order, with their recorded content,
+// and /clock follows the recorded stamps.
+// Publishing does not wait for the subscribers, which may drop frames when
+// they are late. With ~step, a frame is only published when ~step is called,
+// so the caller can wait for the nodes to process each frame and get the
+// same results at each replay.
+
+#include "ros/ros.h"
+#include <rosgraph_msgs/Clock.h>
+#include <toaster_msgs/Empty.h>
+
+#include "pdg/utility/SessionLog.h"
+
+sessionLog::Reader reader;
+bool publishClock = true;
+
+ros::Publisher human_pub;
+ros::Publisher robot_pub;
+ros::Publisher object_pub;
+ros::Publisher fact_pub;
+ros::Publisher clock_pub;
+
+toaster_msgs::HumanListStamped human_msg;
+toaster_msgs::RobotListStamped robot_msg;
+toaster_msgs::ObjectListStamped object_msg;
+toaster_msgs::FactList fact_msg;
+rosgraph_msgs::Clock clock_msg;
+
+unsigned int nextFrame = 0;
+
+void publishFrame(unsigned int i) {
+    const sessionLog::frameIndex_t& frame = reader.frame(i);
+
+    if (publishClock && frame.stamp > clock_msg.clock.toNSec()) {
+        clock_msg.clock.fromNSec(frame.stamp);
+        clock_pub.publish(clock_msg);
+    }
+
+    bool read = false;
+    switch (frame.stream) {
+        case sessionLog::HUMANS:
+            if ((read = reader.read(i, human_msg)))
+                human_pub.publish(human_msg);
+            break;
+        case sessionLog::ROBOTS:
+            if ((read = reader.read(i, robot_msg)))
+                robot_pub.publish(robot_msg);
+            break;
+        case sessionLog::OBJECTS:
+            if ((read = reader.read(i, object_msg)))
+                object_pub.publish(object_msg);
+            break;
+        case sessionLog::FACTS:
+            if ((read = reader.read(i, fact_msg)))
+                fact_pub.publish(fact_msg);
+            break;
+    }
+    if (!read)
+        ROS_WARN("[pdg_replayer] frame %u is corrupted, skipped", i);
+}
+
+// Publishes the next frame, fails at the end of the log
+bool stepCallback(toaster_msgs::Empty::Request& req, toaster_msgs::Empty::Response& res) {
+    if (nextFrame >= reader.nbFrames())
+        return false;
+
+    publishFrame(nextFrame++);
+    if (nextFrame == reader.nbFrames())
+        ROS_INFO("[pdg_replayer] all frames replayed");
+    return true;
+}
+
+int main(int argc, char** argv) {
+    ros::init(argc, argv, "pdg_replayer");
+    ros::NodeHandle node;
+    ros::NodeHandle privateNode("~");
+
+    // speed: 1 is real time, 0 or less publishes as fast as possible
+    std::string path = "pdg_session.tlog";
+    double speed = 1.0;
+    bool step = false;
+    bool waitSubscribers = false;
+    privateNode.getParam("file", path);
+    privateNode.getParam("speed", speed);
+    privateNode.getParam("step", step);
+    privateNode.getParam("clock", publishClock);
+    privateNode.getParam("wait_subscribers", waitSubscribers);
+
+    if (!reader.open(path))
+        return 1;
+
+    human_pub = node.advertise<toaster_msgs::HumanListStamped>("pdg/humanList", 1000);
+    robot_pub = node.advertise<toaster_msgs::RobotListStamped>("pdg/robotList", 1000);
+    object_pub = node.advertise<toaster_msgs::ObjectListStamped>("pdg/objectList", 1000);
+    fact_pub = node.advertise<toaster_msgs::FactList>("pdg/factList", 1000);
+    if (publishClock)
+        clock_pub = node.advertise<rosgraph_msgs::Clock>("/clock", 1000);
+
+    // Without it, the first frames are lost for the nodes still connecting
+    if (waitSubscribers) {
+        ROS_INFO("[pdg_replayer] waiting for subscribers");
+        while (ros::ok() && (human_pub.getNumSubscribers() == 0 || robot_pub.getNumSubscribers() == 0
+                || object_pub.getNumSubscribers() == 0 || fact_pub.getNumSubscribers() == 0))
+            ros::WallDuration(0.1).sleep();
+    }
+
+    if (step) {
+        ros::ServiceServer stepService = privateNode.advertiseService("step", stepCallback);
+        ROS_INFO("[pdg_replayer] %u frames of %s, published at each call of %s", reader.nbFrames(),
+                path.c_str(), stepService.getService().c_str());
+        ros::spin();
+        return 0;
+    }
+
+    ROS_INFO("[pdg_replayer] replaying %u frames of %s", reader.nbFrames(), path.c_str());
+
+    ros::WallTime start = ros::WallTime::now();
+    uint64_t firstStamp = reader.nbFrames() > 0 ? reader.frame(0).stamp : 0;
+
+    for (unsigned int i = 0; i < reader.nbFrames() && ros::ok(); i++) {
+        const sessionLog::frameIndex_t& frame = reader.frame(i);
+
+        if (speed > 0.0 && frame.stamp > firstStamp) {
+            ros::WallTime due = start + ros::WallDuration((frame.stamp - firstStamp) / 1e9 / speed);
+            ros::WallTime now = ros::WallTime::now();
+            if (now < due)
+                (due - now).sleep();
+        }
+
+        publishFrame(i);
+    }
+
+    ROS_INFO("[pdg_replayer] replayed in %f s", (ros::WallTime::now() - start).toSec());
+
+    // Lets the last frames be sent before the publishers are destroyed
+    ros::WallDuration(1.0).sleep();
+    return 0;
+}
@@ -24,40 +24,48 @@ void AdreamMocapHumanReader::init(ros::NodeHandle* node, std::string topicTorso,
   std::cout << "[PDG] Initializing AdreamMocapHumanReader" << std::endl;
   Reader<Human>::init(node, param);
   torso_ = false;
-  // ******************************************
-  // Starts listening to the joint_states
-  subTorso_ = node_->subscribe(topicTorso, 1, &AdreamMocapHumanReader::optitrackCallbackTorso, this);
-  subHead_ = node_->subscribe(topicHead, 1, &AdreamMocapHumanReader::optitrackCallbackHead, this);
-  subHand_ = node_->subscribe(topicHand, 1, &AdreamMocapHumanReader::optitrackCallbackHand, this);
+  topicTorso_ = topicTorso;
+  topicHead_ = topicHead;
+  topicHand_ = topicHand;
+  if (activated_)
+    subscribe();
   std::cout << "Done\n";
 }
 
+void AdreamMocapHumanReader::subscribe()
+{
+  // Starts listening to the topics
+  subTorso_ = node_->subscribe(topicTorso_, 1, &AdreamMocapHumanReader::optitrackCallbackTorso, this);
+  subHead_ = node_->subscribe(topicHead_, 1, &AdreamMocapHumanReader::optitrackCallbackHead, this);
+  subHand_ = node_->subscribe(topicHand_, 1, &AdreamMocapHumanReader::optitrackCallbackHand, this);
+}
+
+void AdreamMocapHumanReader::unsubscribe()
+{
+  subTorso_.shutdown();
+  subHead_.shutdown();
+  subHand_.shutdown();
+}
+
 void AdreamMocapHumanReader::Publish(struct toasterList_t& list_msg)
 {
   if(activated_)
   {
+    std::lock_guard<std::mutex> lock(configMutex());
+    updateLifecycle(list_msg);
     for (std::map<std::string, Human*>::iterator it = lastConfig_.begin(); it != lastConfig_.end(); ++it) {
         if (isPresent(it->first))
         {
-            toaster_msgs::Fact fact_msg = DefaultFactMsg(it->first, it->second->getTime());
-            list_msg.fact_msg.factList.push_back(fact_msg);
+            DefaultFactMsg(nextFactMsg(list_msg), it->first, it->second->getTime());
 
             //Human
-            toaster_msgs::Human human_msg;
-            fillEntity(it->second, human_msg.meAgent.meEntity);
+            agentCache_t* cache;
+            toaster_msgs::Human& human_msg = nextHumanMsg(list_msg, cache);
+            fillEntity(it->second, human_msg.meAgent.meEntity, cache->entity);
 
             //if (humanFullConfig_) {
-            for (std::map<std::string, Joint*>::iterator itJoint = lastConfig_[it->first]->skeleton_.begin(); itJoint != lastConfig_[it->first]->skeleton_.end(); ++itJoint) {
-                toaster_msgs::Joint joint_msg;
-                human_msg.meAgent.skeletonNames.push_back(itJoint->first);
-                fillEntity((itJoint->second), joint_msg.meEntity);
-                joint_msg.jointOwner = it->first;
-
-                human_msg.meAgent.skeletonJoint.push_back(joint_msg);
-
-            }
+            fillSkeleton(it->second->skeleton_, it->first, human_msg.meAgent, *cache, false);
             //}
-            list_msg.human_msg.humanList.push_back(human_msg);
         }
     }
   }
@@ -80,6 +88,7 @@ void AdreamMocapHumanReader::optitrackCallbackHead(const optitrack::or_pose_esti
     }
 
     try {
+        std::lock_guard<std::mutex> lock(configMutex());
         std::string humId = "HERAKLES_HUMAN1";
         //create a new human with the same id as the message
         if (lastConfig_.find(humId) == lastConfig_.end()) {
@@ -187,6 +196,7 @@ void AdreamMocapHumanReader::optitrackCallbackHand(const optitrack::or_pose_esti
     }
 
     try {
+        std::lock_guard<std::mutex> lock(configMutex());
 
         std::string humId = "HERAKLES_HUMAN1";
         std::string jointName = "rightHand";
@@ -252,7 +262,9 @@ void AdreamMocapHumanReader::optitrackCallbackTorso(const optitrack::or_pose_est
         offset_y=0;
         offset_z=0;
     }
+
     try {
+        std::lock_guard<std::mutex> lock(configMutex());
 
         std::string humId = "HERAKLES_HUMAN1";
         std::string jointName = "torso";
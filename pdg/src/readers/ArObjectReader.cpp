@@ -21,9 +21,20 @@ void ArObjectReader::init(ros::NodeHandle* node, std::string topic, std::string
 {
   std::cout << "[PDG] Initializing ArObjectReader" << std::endl;
   Reader<MovableObject>::init(node, param);
-  // ******************************************
-  // Starts listening to the joint_states
-  sub_ = node_->subscribe(topic, 1, &ArObjectReader::CallbackObj, this);
+  topic_ = topic;
+  if (activated_)
+    subscribe();
+}
+
+void ArObjectReader::subscribe()
+{
+  // Starts listening to the topic
+  sub_ = node_->subscribe(topic_, 1, &ArObjectReader::CallbackObj, this);
+}
+
+void ArObjectReader::unsubscribe()
+{
+  sub_.shutdown();
 }
 
 void ArObjectReader::CallbackObj(const visualization_msgs::Marker::ConstPtr& msg) {
@@ -42,8 +53,6 @@ void ArObjectReader::CallbackObj(const visualization_msgs::Marker::ConstPtr& msg
   	} else
   		curObject = globalLastConfig_[msg->ns];
 
-    lastConfigMutex_.unlock();
-
   	//set object position
   	bg::model::point<double, 3, bg::cs::cartesian> objectPosition;
   	objectPosition.set<0>(msg->pose.position.x);
@@ -67,9 +76,8 @@ void ArObjectReader::CallbackObj(const visualization_msgs::Marker::ConstPtr& msg
   	curObject->setPosition(objectPosition);
   	curObject->setTime(now.toNSec());      //Similar to AdreamMoCapHumanReader. Is it better to use time stamp from msg
 
-    lastConfigMutex_.lock();
   	globalLastConfig_[msg->ns]=curObject;
-    lastConfigMutex_.unlock();
     lastConfig_[msg->ns]=curObject;
+    lastConfigMutex_.unlock();
   }
 }
@@ -20,9 +20,20 @@ void GazeboObjectReader::init(ros::NodeHandle* node, std::string topic, std::str
 {
   std::cout << "[PDG] Initializing GazeboObjectReader" << std::endl;
   Reader<MovableObject>::init(node, param);
-  // ******************************************
-  // Starts listening to the joint_states
-  sub_ = node_->subscribe(topic, 1, &GazeboObjectReader::CallbackObj, this);
+  topic_ = topic;
+  if (activated_)
+    subscribe();
+}
+
+void GazeboObjectReader::subscribe()
+{
+  // Starts listening to the topic
+  sub_ = node_->subscribe(topic_, 1, &GazeboObjectReader::CallbackObj, this);
+}
+
+void GazeboObjectReader::unsubscribe()
+{
+  sub_.shutdown();
 }
 
 void GazeboObjectReader::CallbackObj(const gazebo_msgs::ModelStates::ConstPtr& msg) {
@@ -56,7 +67,6 @@ void GazeboObjectReader::CallbackObj(const gazebo_msgs::ModelStates::ConstPtr& m
   		} else{
   		    curObject = globalLastConfig_[objectsName[i]];
   		}
-      lastConfigMutex_.unlock();
 
   		std::vector<double> objOrientation;
   		bg::model::point<double, 3, bg::cs::cartesian> objPosition;
@@ -82,10 +92,9 @@ void GazeboObjectReader::CallbackObj(const gazebo_msgs::ModelStates::ConstPtr& m
   		objOrientation.push_back(yaw);
   		curObject->setOrientation(objOrientation);
 
-      lastConfigMutex_.lock();
   		globalLastConfig_[objectsName[i]] = curObject;
-      lastConfigMutex_.unlock();
       lastConfig_[objectsName[i]] = curObject;
+      lastConfigMutex_.unlock();
   	}
   }
 }
@@ -8,6 +8,7 @@
 #include "pdg/readers/GroupHumanReader.h"
 
 #include "geometry_msgs/PoseStamped.h"
+#include <boost/bind.hpp>
 #include <sys/time.h>
 #include <math.h>
 #include <ostream>
@@ -31,10 +32,35 @@ void GroupHumanReader::init(ros::NodeHandle* node, std::string topic, std::strin
 {
   std::cout << "[PDG] Initializing GroupHumanReader" << std::endl;
   Reader<Human>::init(node, param);
-  // ******************************************
-  // Starts listening to the joint_states
-  sub_ = node_->subscribe(topic, 1, &GroupHumanReader::groupTrackCallback, this);
-  listener_ = new tf::TransformListener;
+  topic_ = topic;
+
+  double tfTimeout = 3.0;
+  node_->getParam("/pdg/tfTimeout", tfTimeout);
+  tfQueue_.setTimeout(tfTimeout);
+
+  if (activated_)
+    subscribe();
+}
+
+void GroupHumanReader::subscribe()
+{
+  // The listener is only created once the reader is used.
+  // Tracks wait for their transform without blocking the callbacks
+  if (listener_ == nullptr)
+  {
+    listener_ = new tf::TransformListener;
+    tfQueue_.init(node_, listener_, "/map", boost::bind(&GroupHumanReader::groupTrackTransformable, this, _1));
+  }
+  else
+    tfQueue_.start();
+  // Starts listening to the topic
+  sub_ = node_->subscribe(topic_, 1, &GroupHumanReader::groupTrackCallback, this);
+}
+
+void GroupHumanReader::unsubscribe()
+{
+  sub_.shutdown();
+  tfQueue_.stop();
 }
 
 /*
@@ -42,26 +68,32 @@ void GroupHumanReader::init(ros::NodeHandle* node, std::string topic, std::strin
   their positions and orientations.
  */
 void GroupHumanReader::groupTrackCallback(const spencer_tracking_msgs::TrackedGroups::ConstPtr& msg) {
-    tf::StampedTransform transform;
+    tfQueue_.add(msg);
+}
+
+// Called once the transform from the groupTrack frame to map is available
+void GroupHumanReader::groupTrackTransformable(const spencer_tracking_msgs::TrackedGroups::ConstPtr& msg) {
     ros::Time now = ros::Time::now();
-    std::stringstream humId;
 
     try {
         std::string frame;
         frame = msg->header.frame_id;
 
-        //transform from the groupTrack frame to map
-        listener_->waitForTransform("/map", frame,
-                msg->header.stamp, ros::Duration(3.0));
-        listener_->lookupTransform("/map", frame,
-                msg->header.stamp, transform);
-
         //for every group present in the tracking message
+        std::lock_guard<std::mutex> lock(configMutex());
         for (int i = 0; i < msg->groups.size(); i++) {
             spencer_tracking_msgs::TrackedGroup group = msg->groups[i];
+            std::stringstream humId;
             humId << " group" << group.group_id;
-            //create a new human with the same id as the message
-            Human* curHuman = new Human(humId.str());
+            //create a new human with the same id as the message, or update it
+            Human* curHuman;
+            std::map<std::string, Human*>::iterator it = lastConfig_.find(humId.str());
+            if (it == lastConfig_.end()) {
+                curHuman = new Human(humId.str());
+                lastConfig_[humId.str()] = curHuman;
+            } else {
+                curHuman = it->second;
+            }
 
             //get the pose of the agent in the groupTrack frame and transform it to the map frame
             geometry_msgs::PoseStamped groupTrackPose, mapPose;
@@ -91,8 +123,6 @@ void GroupHumanReader::groupTrackCallback(const spencer_tracking_msgs::TrackedGr
             curHuman->setOrientation(humanOrientation);
             curHuman->setPosition(humanPosition);
             curHuman->setTime(now.toNSec());
-
-            lastConfig_[humId.str()] = curHuman;
         }
     } catch (tf::TransformException ex) {
         ROS_ERROR("%s", ex.what());
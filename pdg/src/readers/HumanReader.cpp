@@ -15,24 +15,33 @@ HumanReader::~HumanReader()
 }
 
 bool HumanReader::isPresent(std::string id){
-  timeval curTime;
-  gettimeofday(&curTime, NULL);
-  unsigned long now = curTime.tv_sec * pow(10,9) + curTime.tv_usec;
-  unsigned long timeThreshold = pow(10,9);
-  //std::cout << "current time: " << now <<  "  human time: " << m_LastTime << std::endl;
-  long timeDif = lastConfig_[id]->getTime() - now;
-  //std::cout << "time dif: " << timeDif << std::endl;
-
-  if ( fabs(timeDif) < timeThreshold)
-      return true;
-  else
-      return false;
+  return lifecycle_.isLive(id);
 }
 
-toaster_msgs::Fact HumanReader::DefaultFactMsg(std::string subjectId, uint64_t factTime)
+void HumanReader::updateLifecycle(struct toasterList_t& list_msg)
 {
-  toaster_msgs::Fact fact_msg;
+  // Readers stamp their humans with ros::Time, which is sim time under a simulator
+  uint64_t now = ros::Time::now().toNSec();
+  for (std::map<std::string, Human *>::iterator it = lastConfig_.begin(); it != lastConfig_.end(); ++it)
+    lifecycle_.seen(it->first, it->second->getTime(), now);
+
+  std::vector<std::string> evicted;
+  lifecycle_.update(now, evicted);
+  for (unsigned int i = 0; i < evicted.size(); i++)
+  {
+    std::map<std::string, Human *>::iterator it = lastConfig_.find(evicted[i]);
+    if (it != lastConfig_.end())
+    {
+      delete it->second;
+      lastConfig_.erase(it);
+    }
+  }
+
+  lifecycle_.takeEvents(list_msg.entityEvents);
+}
 
+void HumanReader::DefaultFactMsg(toaster_msgs::Fact& fact_msg, const std::string& subjectId, uint64_t factTime)
+{
   //Fact
   fact_msg.property = "isPresent";
   fact_msg.subjectId = subjectId;
@@ -41,24 +50,25 @@ toaster_msgs::Fact HumanReader::DefaultFactMsg(std::string subjectId, uint64_t f
   fact_msg.factObservability = 1.0;
   fact_msg.time = factTime;
   fact_msg.valueType = 0;
-
-  return fact_msg;
 }
 
 void HumanReader::Publish(struct toasterList_t& list_msg)
 {
   if(activated_)
   {
+    std::lock_guard<std::mutex> lock(configMutex());
+    updateLifecycle(list_msg);
     for (std::map<std::string, Human *>::iterator it = lastConfig_.begin(); it != lastConfig_.end(); ++it)
     {
       if (isPresent(it->first))
       {
-          toaster_msgs::Fact fact_msg = DefaultFactMsg(it->first, it->second->getTime());
-          list_msg.fact_msg.factList.push_back(fact_msg);
+          DefaultFactMsg(nextFactMsg(list_msg), it->first, it->second->getTime());
 
-          toaster_msgs::Human human_msg;
-          fillEntity(it->second, human_msg.meAgent.meEntity);
-          list_msg.human_msg.humanList.push_back(human_msg);
+          agentCache_t* cache;
+          toaster_msgs::Human& human_msg = nextHumanMsg(list_msg, cache);
+          fillEntity(it->second, human_msg.meAgent.meEntity, cache->entity);
+          human_msg.meAgent.skeletonNames.clear();
+          human_msg.meAgent.skeletonJoint.clear();
       }
     }
   }
@@ -24,10 +24,23 @@ void MocapHumanReader::init(ros::NodeHandle* node, std::string topic, std::strin
 {
   std::cout << "[PDG] Initializing MocapHumanReader" << std::endl;
   Reader<Human>::init(node, param);
-  // ******************************************
-  // Starts listening to the joint_states
-  sub_ = node_->subscribe(topic, 1, &MocapHumanReader::optitrackCallback, this);
-  listener_ = new tf::TransformListener;
+  topic_ = topic;
+  if (activated_)
+    subscribe();
+}
+
+void MocapHumanReader::subscribe()
+{
+  // The listener is only created once the reader is used
+  if (listener_ == nullptr)
+    listener_ = new tf::TransformListener;
+  // Starts listening to the topic
+  sub_ = node_->subscribe(topic_, 1, &MocapHumanReader::optitrackCallback, this);
+}
+
+void MocapHumanReader::unsubscribe()
+{
+  sub_.shutdown();
 }
 
 /*
@@ -51,6 +64,7 @@ void MocapHumanReader::optitrackCallback(const spencer_tracking_msgs::TrackedPer
                 msg->header.stamp, transform);
 
         //for every agent present in the tracking message
+        std::lock_guard<std::mutex> lock(configMutex());
         for (int i = 0; i < msg->tracks.size(); i++) {
             std::string humanName = "human";
             spencer_tracking_msgs::TrackedPerson person = msg->tracks[i];
@@ -15,6 +15,10 @@ void MorseHumanReader::init(ros::NodeHandle* node, std::string param)
 {
   std::cout << "[PDG] Initializing MorseHumanReader" << std::endl;
   Reader<Human>::init(node, param);
+
+  double tfTimeout = 3.0;
+  node_->getParam("/pdg/tfTimeout", tfTimeout);
+  tfTimeout_ = ros::Duration(tfTimeout);
 }
 
 void MorseHumanReader::updateHumans(tf::TransformListener &listener) {
@@ -25,19 +29,26 @@ void MorseHumanReader::updateHumans(tf::TransformListener &listener) {
 
 void MorseHumanReader::updateHuman(tf::TransformListener &listener, std::string humId, std::string humanBase){
   tf::StampedTransform transform;
-  Human* curHuman = new Human(humId);
-  //TODO set name with humId
-  curHuman->setName("human1");
   std::vector<double> humanOrientation;
   bg::model::point<double, 3, bg::cs::cartesian> humanPosition;
 
+  // This runs in the main loop: the last transform is taken without waiting,
+  // and ignored if it is older than the timeout
+  if (!listener.canTransform("/map", humanBase, ros::Time(0)))
+    return;
 
   try{
-    ros::Time now = ros::Time::now();
-    listener.waitForTransform("/map", humanBase,
-        now, ros::Duration(3.0));
-        listener.lookupTransform("/map", humanBase,
-        now, transform);
+    listener.lookupTransform("/map", humanBase,
+        ros::Time(0), transform);
+
+        if (ros::Time::now() - transform.stamp_ > tfTimeout_) {
+          ROS_WARN_THROTTLE(5.0, "[PDG] transform of %s is too old, %s not updated", humanBase.c_str(), humId.c_str());
+          return;
+        }
+
+        Human* curHuman = new Human(humId);
+        //TODO set name with humId
+        curHuman->setName("human1");
 
         //Human position
         humanPosition.set<0>(transform.getOrigin().x());
@@ -53,8 +64,10 @@ void MorseHumanReader::updateHuman(tf::TransformListener &listener, std::string
 
         curHuman->setOrientation(humanOrientation);
         curHuman->setPosition(humanPosition);
-        curHuman->setTime(now.toNSec());
+        curHuman->setTime(transform.stamp_.toNSec());
 
+        std::lock_guard<std::mutex> lock(configMutex());
+        delete lastConfig_[humId];
         lastConfig_[humId] = curHuman;
 
   }
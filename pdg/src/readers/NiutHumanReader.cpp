@@ -11,9 +11,20 @@ void NiutHumanReader::init(ros::NodeHandle* node, std::string topic, std::string
 {
   std::cout << "[PDG] Initializing NiutHumanReader" << std::endl;
   Reader<Human>::init(node, param);
-  // ******************************************
-  // Starts listening to the joint_states
-  sub_ = node_->subscribe(topic, 1, &NiutHumanReader::humanJointCallBack, this);
+  topic_ = topic;
+  if (activated_)
+    subscribe();
+}
+
+void NiutHumanReader::subscribe()
+{
+  // Starts listening to the topic
+  sub_ = node_->subscribe(topic_, 1, &NiutHumanReader::humanJointCallBack, this);
+}
+
+void NiutHumanReader::unsubscribe()
+{
+  sub_.shutdown();
 }
 
 void NiutHumanReader::humanJointCallBack(const niut_msgs::niut_HUMAN_LIST::ConstPtr& msg) {
@@ -27,6 +38,7 @@ void NiutHumanReader::humanJointCallBack(const niut_msgs::niut_HUMAN_LIST::Const
     trackedJoints.push_back(22);
 
     //msg->filtered_users[i];
+    std::lock_guard<std::mutex> lock(configMutex());
     for (int i = 0; i < NB_MAX_NIUT; i++) {
         if (msg->filtered_users[i].trackedId > -1 && msg->filtered_users[i].date.t_sec != 0) {
 
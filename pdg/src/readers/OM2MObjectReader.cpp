@@ -9,20 +9,6 @@
 
 #include "pdg/utility/XmlUtility.h"
 
-enum objectType_t
-{
-  sensor,
-  other
-};
-
-struct preFact_t
-{
-  std::string type;
-  std::string data;
-  std::string param;
-  enum objectType_t objectType;
-};
-
 OM2MObjectReader::OM2MObjectReader() : ObjectReader(){
     childs_.push_back(this);
 }
@@ -31,73 +17,21 @@ void OM2MObjectReader::init(ros::NodeHandle* node, std::string topic, std::strin
 {
   std::cout << "[PDG] Initializing OM2MObjectReader" << std::endl;
   Reader<MovableObject>::init(node, param);
-  // ******************************************
-  // Starts listening to the joint_states
-  sub_ = node_->subscribe(topic, 1, &OM2MObjectReader::newValueCallBack, this);
+  topic_ = topic;
+  if (activated_)
+    subscribe();
   std::cout << "Done\n";
 }
 
-std::string OM2MObjectReader::getSubpart(std::string data, std::string start, std::string stop)
+void OM2MObjectReader::subscribe()
 {
-  std::string part  = "";
-  if(data.find(start) != string::npos)
-  {
-    size_t start_pos = data.find(start);
-    size_t stop_pos = data.find(stop, start_pos);
-    part = data.substr(start_pos+start.length(), stop_pos-start_pos-start.length());
-  }
-
-  return part;
+  // Starts listening to the topic
+  sub_ = node_->subscribe(topic_, 1, &OM2MObjectReader::newValueCallBack, this);
 }
 
-vector<struct preFact_t> OM2MObjectReader::readPreFacts(MovableObject* object)
+void OM2MObjectReader::unsubscribe()
 {
-  vector<struct preFact_t> preFacts;
-  size_t start_pos = 0;
-  std::string content = object->getValue();
-  while(content.find("\n", start_pos) != string::npos)
-  {
-    size_t stop_pos = content.find("\n", start_pos);
-    std::string data = content.substr(start_pos, stop_pos-start_pos);
-    if(data.find("=") != string::npos) // if valid data
-    {
-      size_t pos = data.find("=");
-      std::string name = data.substr(0, pos);
-      std::string type = getSubpart(data, "type=", " /");
-      std::string value = getSubpart(data, "data=", " /");
-      std::string unit = getSubpart(data, "unit=", " /");
-      std::string color = getSubpart(data, "color=", " /");
-
-      struct preFact_t preFact;
-      if(name != "DATA")
-        preFact.type = name;
-      else if(type != "")
-        preFact.type = type;
-      else
-        preFact.type = "";
-
-      if(value == "true")
-        preFact.data = "active";
-      else if(value == "false")
-        preFact.data = "inactive";
-      else
-        preFact.data = value;
-
-      if((unit != "") && (data != "true") && (data != "false"))
-        preFact.objectType = sensor;
-      else
-        preFact.objectType = other;
-
-      if((color != "") && (preFact.type.find("LAMP") != string::npos))
-        preFact.param = color;
-
-      if(preFact.type != "")
-        preFacts.push_back(preFact);
-    }
-
-    start_pos = stop_pos+1;
-  }
-  return preFacts;
+  sub_.shutdown();
 }
 
 void OM2MObjectReader::Publish(struct toasterList_t& list_msg)
@@ -106,8 +40,16 @@ void OM2MObjectReader::Publish(struct toasterList_t& list_msg)
   for (std::map<std::string, MovableObject *>::iterator it_obj = globalLastConfig_.begin();
        it_obj != globalLastConfig_.end(); ++it_obj)
   {
+    // Values of all objects give pre facts, they are read again only when the value changes
+    objectPreFacts_t& objectPreFacts = preFacts_[it_obj->first];
+    std::string value = it_obj->second->getValue();
+    if (value != objectPreFacts.value)
+    {
+      objectPreFacts.value = value;
+      readPreFacts(objectPreFacts.value, objectPreFacts.preFacts);
+    }
 
-    vector<struct preFact_t> preFacts = readPreFacts(it_obj->second);
+    vector<struct preFact_t>& preFacts = objectPreFacts.preFacts;
     for(vector<struct preFact_t>::iterator it = preFacts.begin(); it != preFacts.end(); ++it)
     {
       toaster_msgs::Fact fact_msg;
@@ -153,7 +95,19 @@ void OM2MObjectReader::Publish(struct toasterList_t& list_msg)
 
       fact_msg.property = it->type;
 
-      list_msg.fact_msg.factList.push_back(fact_msg);
+      nextFactMsg(list_msg) = fact_msg;
+    }
+  }
+
+  // Objects which were removed
+  if (preFacts_.size() > globalLastConfig_.size())
+  {
+    for (std::map<std::string, objectPreFacts_t>::iterator it = preFacts_.begin(); it != preFacts_.end();)
+    {
+      if (globalLastConfig_.find(it->first) == globalLastConfig_.end())
+        preFacts_.erase(it++);
+      else
+        ++it;
     }
   }
   lastConfigMutex_.unlock();
@@ -177,8 +131,6 @@ void OM2MObjectReader::newValueCallBack(const toaster_msgs::IoTData::ConstPtr& m
     } else
         curObject = (MovableObject*)globalLastConfig_[msg->data.key];
 
-    lastConfigMutex_.unlock();
-
     //set object position at default : 0,0,0
     bg::model::point<double, 3, bg::cs::cartesian> objectPosition;
     objectPosition.set<0>(0);
@@ -203,12 +155,10 @@ void OM2MObjectReader::newValueCallBack(const toaster_msgs::IoTData::ConstPtr& m
     curObject->setValue(msg->data.value);
 
     // set the time
-    unsigned long micro_sec = msg->header.stamp.sec * 1000000;
-    curObject->setTime(micro_sec);
+    curObject->setTime(msg->header.stamp.toNSec());
 
-    lastConfigMutex_.lock();
     globalLastConfig_[msg->data.key]=curObject;
-    lastConfigMutex_.unlock();
     lastConfig_[msg->data.key]=curObject;
+    lastConfigMutex_.unlock();
   }
 }
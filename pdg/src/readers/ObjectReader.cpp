@@ -6,6 +6,8 @@ unsigned int ObjectReader::nbObjects_ = 0;
 std::vector<ObjectReader*> ObjectReader::childs_;
 std::map<std::string, MovableObject*> ObjectReader::globalLastConfig_;
 std::mutex ObjectReader::lastConfigMutex_;
+EntityLifecycle ObjectReader::lifecycle_;
+bool ObjectReader::lifecycleEnabled_ = false;
 unsigned int ObjectReader::nbReaders_ = 0;
 
 ObjectReader::ObjectReader() : Reader<MovableObject>()
@@ -30,17 +32,16 @@ ObjectReader::~ObjectReader()
 
 bool ObjectReader::isPresent(std::string id)
 {
-  timeval curTime;
-  gettimeofday(&curTime, NULL);
-  unsigned long now = curTime.tv_sec * pow(10,9) + curTime.tv_usec;
-  unsigned long timeThreshold = pow(10,9);
-
-  long timeDif = lastConfig_[id]->getTime() - now;
+  if (!lifecycleEnabled_)
+    return true;
+  return lifecycle_.isLive(id);
+}
 
-  if ( fabs(timeDif) < timeThreshold)
-      return true;
-  else
-      return false;
+void ObjectReader::setLifecycleTimes(uint64_t staleTime, uint64_t evictTime)
+{
+  std::lock_guard<std::mutex> lock(lastConfigMutex_);
+  lifecycle_.setTimes(staleTime, evictTime);
+  lifecycleEnabled_ = evictTime > 0;
 }
 
 void ObjectReader::Publish(struct toasterList_t& list_msg, struct objectIn_t& objectIn)
@@ -49,16 +50,44 @@ void ObjectReader::Publish(struct toasterList_t& list_msg, struct objectIn_t& ob
     (*it)->Publish(list_msg);
 
   lastConfigMutex_.lock();
+  if (lifecycleEnabled_)
+  {
+    // Readers stamp their objects with ros::Time, which is sim time under a simulator
+    uint64_t now = ros::Time::now().toNSec();
+    for (std::map<std::string, MovableObject *>::iterator it = globalLastConfig_.begin();
+         it != globalLastConfig_.end(); ++it)
+      lifecycle_.seen(it->first, it->second->getTime(), now);
+
+    std::vector<std::string> evicted;
+    lifecycle_.update(now, evicted);
+    for (unsigned int i = 0; i < evicted.size(); i++)
+    {
+      std::map<std::string, MovableObject *>::iterator it = globalLastConfig_.find(evicted[i]);
+      if (it != globalLastConfig_.end())
+      {
+        // Readers keep their own pointer to the object, under the same mutex
+        for (unsigned int j = 0; j < childs_.size(); j++)
+          childs_[j]->lastConfig_.erase(evicted[i]);
+        delete it->second;
+        globalLastConfig_.erase(it);
+      }
+    }
+    lifecycle_.takeEvents(list_msg.entityEvents);
+  }
+
   for (std::map<std::string, MovableObject *>::iterator it = globalLastConfig_.begin();
        it != globalLastConfig_.end(); ++it)
   {
+      // Objects not seen lately are not published until seen again, unless in hand
+      if (!isPresent(it->first) && objectIn.Agent_.find(it->first) == objectIn.Agent_.end())
+        continue;
       // If in hand, modify position:
       putInHand(objectIn, it->first, it->second, list_msg);
       //Message for object
-      toaster_msgs::Object object_msg;
+      orientationCache_t* cache;
+      toaster_msgs::Object& object_msg = nextObjectMsg(list_msg, cache);
       fillValue(it->second, object_msg);
-      fillEntity(it->second, object_msg.meEntity);
-      list_msg.object_msg.objectList.push_back(object_msg);
+      fillEntity(it->second, object_msg.meEntity, *cache);
   }
   lastConfigMutex_.unlock();
 }
@@ -69,10 +98,8 @@ void ObjectReader::increaseNbObjects()
   nbLocalObjects_++;
 }
 
-toaster_msgs::Fact ObjectReader::DefaultFactMsg(string id, MovableObject* object, struct objectIn_t& objectIn)
+void ObjectReader::DefaultFactMsg(toaster_msgs::Fact& fact_msg, string id, MovableObject* object, struct objectIn_t& objectIn)
 {
-  toaster_msgs::Fact fact_msg;
-
   //Fact message
   fact_msg.property = "IsInHand";
   fact_msg.propertyType = "position";
@@ -85,8 +112,6 @@ toaster_msgs::Fact ObjectReader::DefaultFactMsg(string id, MovableObject* object
   fact_msg.time = object->getTime();
   fact_msg.valueType = 0;
   fact_msg.stringValue = "true";
-
-  return fact_msg;
 }
 
 void ObjectReader::putInHand(struct objectIn_t& objectIn, string id, MovableObject* object, struct toasterList_t& list_msg)
@@ -95,19 +120,16 @@ void ObjectReader::putInHand(struct objectIn_t& objectIn, string id, MovableObje
   {
     bool addFactHand = true;
     if (!putAtJointPosition(object, objectIn.Agent_[id], objectIn.Hand_[id],
-                            list_msg.human_msg, true)) // try to put in human
-      if (!putAtJointPosition(object, objectIn.Agent_[id], objectIn.Hand_[id],
-                              list_msg.robot_msg, true)) // try to put in robot
-      {
-        ROS_INFO("[pdg][put_in_hand] couldn't find joint %s for agent %s \n",
-                 objectIn.Hand_[id].c_str(), objectIn.Agent_[id].c_str());
-        addFactHand = false;
-      }
+                            list_msg, true)) // try to put in human or robot
+    {
+      ROS_INFO("[pdg][put_in_hand] couldn't find joint %s for agent %s \n",
+               objectIn.Hand_[id].c_str(), objectIn.Agent_[id].c_str());
+      addFactHand = false;
+    }
 
     if (addFactHand)
     {
-      toaster_msgs::Fact fact_msg= DefaultFactMsg(id, object, objectIn);
-      list_msg.fact_msg.factList.push_back(fact_msg);
+      DefaultFactMsg(nextFactMsg(list_msg), id, object, objectIn);
     }
   }
 }
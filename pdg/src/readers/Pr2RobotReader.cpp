@@ -8,15 +8,30 @@ void Pr2RobotReader::init(ros::NodeHandle* node, std::string param) {
   std::cout << "[PDG] Initializing Pr2RobotReader" << std::endl;
   Reader<Robot>::init(node, param);
 
-  if (fullRobot_)
-      sub_ = node_->subscribe("joint_states", 1, &Pr2RobotReader::pr2JointStateCallBack, this);
-
   initJointsName_ = false;
   Robot* curRobot = new Robot("pr2");
   //TODO: setname with id
   curRobot->setName("PR2_ROBOT");
 
   lastConfig_["pr2"] = curRobot;
+
+  if (activated_)
+    subscribe();
+}
+
+void Pr2RobotReader::subscribe()
+{
+  if (fullRobot_) {
+      // The description is only loaded once the reader is used
+      if (!kinematics_.isLoaded())
+          kinematics_.load("robot_description");
+      sub_ = node_->subscribe("joint_states", 1, &Pr2RobotReader::pr2JointStateCallBack, this);
+  }
+}
+
+void Pr2RobotReader::unsubscribe()
+{
+  sub_.shutdown();
 }
 
 
@@ -48,9 +63,39 @@ void Pr2RobotReader::init(ros::NodeHandle* node, std::string param) {
 
 void Pr2RobotReader::updateRobot(tf::TransformListener &listener)
 {
-  if(fullRobot_)
+  if(fullRobot_ && activated_)
   {
+    std::lock_guard<std::mutex> lock(configMutex());
     Robot* curRobot = lastConfig_["pr2"];
+
+    if (kinematics_.isLoaded()) {
+        // One lookup for the root, links poses from the joint positions
+        tf::StampedTransform root;
+        if (!lookupTransform(listener, "/" + kinematics_.rootLink(), root))
+            return;
+
+        uint64_t time = ros::Time::now().toNSec();
+        kinematics_.update();
+
+        int baseLink = kinematics_.linkIndex("base_link");
+        if (baseLink >= 0)
+            setLocation(curRobot, root * kinematics_.linkPose(baseLink), time);
+        else
+            setLocation(curRobot, root, time);
+
+        if (initJointsName_) {
+            for (unsigned int i = 0; i < pr2JointsName_.size(); i++) {
+                Joint* curJoint = curRobot->skeleton_[pr2JointsName_[i]];
+                curJoint->setName(pr2JointsName_[i]);
+                if (jointsLink_[i] >= 0)
+                    setLocation(curJoint, root * kinematics_.linkPose(jointsLink_[i]), time);
+                else
+                    setRobotJointLocation(listener, curJoint);
+            }
+        }
+        return;
+    }
+
     Joint* curJoint = new Joint("pr2_base_link", "pr2");
     curJoint->setName("base_link");
 
@@ -74,45 +119,54 @@ void Pr2RobotReader::updateRobot(tf::TransformListener &listener)
   }
 }
 
-void Pr2RobotReader::setRobotJointLocation(tf::TransformListener &listener, Joint* joint) {
-    tf::StampedTransform transform;
-    std::string jointId = "/";
-    std::vector<double> jointOrientation;
-    bg::model::point<double, 3, bg::cs::cartesian> jointPosition;
-    jointId.append(joint->getName());
-
-    ROS_DEBUG("current joint %s \n", jointId.c_str());
+bool Pr2RobotReader::lookupTransform(tf::TransformListener &listener, const std::string& frame, tf::StampedTransform& transform) {
+    ROS_DEBUG("current joint %s \n", frame.c_str());
 
     try {
-        ros::Time now = ros::Time::now();
         ros::Time last = ros::Time(0);
-        listener.waitForTransform("/map", jointId,
+        listener.waitForTransform("/map", frame,
                 last, ros::Duration(0.0));
-        listener.lookupTransform("/map", jointId,
+        listener.lookupTransform("/map", frame,
                 last, transform);
-
-        //Joint position
-        jointPosition.set<0>(transform.getOrigin().x());
-        jointPosition.set<1>(transform.getOrigin().y());
-        jointPosition.set<2>(transform.getOrigin().z());
-
-        //Joint orientation
-        //curRobot->orientation.push_back(tf::getRoll(transform.getRotation()));
-        //curRobot->orientation.push_back(tf::getPitch(transform.getRotation()));
-        jointOrientation.push_back(0.0);
-        jointOrientation.push_back(0.0);
-        jointOrientation.push_back(tf::getYaw(transform.getRotation()));
-
-        joint->setTime(now.toNSec());
-        joint->setPosition(jointPosition);
-        joint->setOrientation(jointOrientation);
+        return true;
 
     } catch (tf::TransformException ex) {
         ROS_ERROR("%s", ex.what());
+        return false;
     }
 }
 
+void Pr2RobotReader::setLocation(Entity* entity, const tf::Transform& transform, uint64_t time) {
+    std::vector<double> orientation;
+    bg::model::point<double, 3, bg::cs::cartesian> position;
+
+    //Position
+    position.set<0>(transform.getOrigin().x());
+    position.set<1>(transform.getOrigin().y());
+    position.set<2>(transform.getOrigin().z());
+
+    //Orientation
+    orientation.push_back(0.0);
+    orientation.push_back(0.0);
+    orientation.push_back(tf::getYaw(transform.getRotation()));
+
+    entity->setTime(time);
+    entity->setPosition(position);
+    entity->setOrientation(orientation);
+}
+
+void Pr2RobotReader::setRobotJointLocation(tf::TransformListener &listener, Joint* joint) {
+    tf::StampedTransform transform;
+    std::string jointId = "/";
+    jointId.append(joint->getName());
+
+    ros::Time now = ros::Time::now();
+    if (lookupTransform(listener, jointId, transform))
+        setLocation(joint, transform, now.toNSec());
+}
+
 void Pr2RobotReader::pr2JointStateCallBack(const sensor_msgs::JointState::ConstPtr & msg) {
+    std::lock_guard<std::mutex> lock(configMutex());
     if (!initJointsName_) {
         for (unsigned int i = 0; i < msg->name.size(); i++) {
             std::string jointName = msg->name[i];
@@ -125,11 +179,15 @@ void Pr2RobotReader::pr2JointStateCallBack(const sensor_msgs::JointState::ConstP
             jointId << "pr2";
             jointId << msg->name[i];
             lastConfig_["pr2"]->skeleton_[pr2JointsName_[i]] = new Joint(jointId.str(), "pr2");
+            jointsLink_.push_back(kinematics_.linkIndex(jointName));
 
         }
         initJointsName_ = true;
     }
 
+    if (kinematics_.isLoaded())
+        kinematics_.setJointPositions(*msg);
+
     if (pr2JointsName_.size() == msg->position.size()) {
         for (unsigned int i = 0; i < pr2JointsName_.size(); i++) {
             lastConfig_["pr2"]->skeleton_[pr2JointsName_[i]]->position = msg->position[i];
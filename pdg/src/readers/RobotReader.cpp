@@ -15,34 +15,26 @@ void RobotReader::Publish(struct toasterList_t& list_msg)
 {
   if(activated_)
   {
+    std::lock_guard<std::mutex> lock(configMutex());
     for (std::map<std::string, Robot *>::iterator it = lastConfig_.begin();
          it != lastConfig_.end(); ++it) {
 
-        toaster_msgs::Fact fact_msg = DefaultFactMsg(it->first, it->second->getTime());
-        list_msg.fact_msg.factList.push_back(fact_msg);
+        DefaultFactMsg(nextFactMsg(list_msg), it->first, it->second->getTime());
 
         //Robot
-        toaster_msgs::Robot robot_msg;
+        agentCache_t* cache;
+        toaster_msgs::Robot& robot_msg = nextRobotMsg(list_msg, cache);
         robot_msg.meAgent.mobility = 0;
 
-        fillEntity(lastConfig_[it->first], robot_msg.meAgent.meEntity);
+        fillEntity(it->second, robot_msg.meAgent.meEntity, cache->entity);
 
         if (fullRobot_)
+            fillSkeleton(it->second->skeleton_, it->first, robot_msg.meAgent, *cache, true);
+        else
         {
-            for (std::map<std::string, Joint *>::iterator itJoint = lastConfig_[it->first]->skeleton_.begin();
-                 itJoint != lastConfig_[it->first]->skeleton_.end(); ++itJoint)
-            {
-                toaster_msgs::Joint joint_msg;
-                robot_msg.meAgent.skeletonNames.push_back(itJoint->first);
-                fillEntity((itJoint->second), joint_msg.meEntity);
-
-                joint_msg.jointOwner = it->first;
-                joint_msg.position = itJoint->second->position;
-
-                robot_msg.meAgent.skeletonJoint.push_back(joint_msg);
-            }
+            robot_msg.meAgent.skeletonNames.clear();
+            robot_msg.meAgent.skeletonJoint.clear();
         }
-        list_msg.robot_msg.robotList.push_back(robot_msg);
     }
   }
 }
@@ -61,10 +53,8 @@ bool RobotReader::isPresent(std::string id){
       return false;
 }
 
-toaster_msgs::Fact RobotReader::DefaultFactMsg(std::string subjectId, uint64_t factTime)
+void RobotReader::DefaultFactMsg(toaster_msgs::Fact& fact_msg, const std::string& subjectId, uint64_t factTime)
 {
-  toaster_msgs::Fact fact_msg;
-
   //Fact
   fact_msg.property = "isPresent";
   fact_msg.subjectId = subjectId;
@@ -73,6 +63,4 @@ toaster_msgs::Fact RobotReader::DefaultFactMsg(std::string subjectId, uint64_t f
   fact_msg.factObservability = 1.0;
   fact_msg.time = factTime;
   fact_msg.valueType = 0;
-
-  return fact_msg;
 }
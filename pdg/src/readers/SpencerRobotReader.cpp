@@ -32,6 +32,7 @@ void SpencerRobotReader::updateRobot(tf::TransformListener &listener)
 {
   if(fullRobot_)
   {
+    std::lock_guard<std::mutex> lock(configMutex());
     Robot* curRobot = lastConfig_["spencer"];
     Joint* curJoint = new Joint("spencer_base_link", "spencer");
     curJoint->setName(spencerJointsName_[0]);
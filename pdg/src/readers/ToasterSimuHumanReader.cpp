@@ -17,32 +17,37 @@ void ToasterSimuHumanReader::init(ros::NodeHandle* node, std::string param)
 {
   std::cout << "[PDG] Initializing ToasterHumanReader" << std::endl;
   Reader<Human>::init(node, param);
-  // ******************************************
-  // Starts listening to the joint_states
+  if (activated_)
+    subscribe();
+}
+
+void ToasterSimuHumanReader::subscribe()
+{
+  // Starts listening to the topic
   sub_ = node_->subscribe("/toaster_simu/humanList", 1, &ToasterSimuHumanReader::humanJointStateCallBack, this);
 }
 
+void ToasterSimuHumanReader::unsubscribe()
+{
+  sub_.shutdown();
+}
+
 void ToasterSimuHumanReader::Publish(struct toasterList_t& list_msg)
 {
   if(activated_)
   {
+    std::lock_guard<std::mutex> lock(configMutex());
+    updateLifecycle(list_msg);
     for (std::map<std::string, Human*>::iterator it = lastConfig_.begin(); it != lastConfig_.end(); ++it) {
-        //Human
-        toaster_msgs::Human human_msg;
-        fillEntity(it->second, human_msg.meAgent.meEntity);
-
-        human_msg.meAgent.skeletonJoint.clear();
-        human_msg.meAgent.skeletonNames.clear();
+        if (!isPresent(it->first))
+            continue;
 
-        for (std::map<std::string, Joint*>::iterator itJoint = lastConfig_[it->first]->skeleton_.begin(); itJoint != lastConfig_[it->first]->skeleton_.end(); ++itJoint) {
-            toaster_msgs::Joint joint_msg;
-            human_msg.meAgent.skeletonNames.push_back(itJoint->first);
-            fillEntity((itJoint->second), joint_msg.meEntity);
-            joint_msg.jointOwner = it->first;
+        //Human
+        agentCache_t* cache;
+        toaster_msgs::Human& human_msg = nextHumanMsg(list_msg, cache);
+        fillEntity(it->second, human_msg.meAgent.meEntity, cache->entity);
 
-            human_msg.meAgent.skeletonJoint.push_back(joint_msg);
-        }
-        list_msg.human_msg.humanList.push_back(human_msg);
+        fillSkeleton(it->second->skeleton_, it->first, human_msg.meAgent, *cache, false);
     }
   }
 }
@@ -51,6 +56,7 @@ void ToasterSimuHumanReader::humanJointStateCallBack(const toaster_msgs::HumanLi
     //std::cout << "[area_manager][DEBUG] new data for human received with time " << msg->humanList[0].meAgent.meEntity.time  << std::endl;
     Human * curHuman;
     double roll, pitch, yaw;
+    std::lock_guard<std::mutex> lock(configMutex());
     for (unsigned int i = 0; i < msg->humanList.size(); i++) {
 
         // If this human is not assigned we have to allocate data.
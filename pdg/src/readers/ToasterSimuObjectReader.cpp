@@ -16,11 +16,21 @@ void ToasterSimuObjectReader::init(ros::NodeHandle* node, std::string param)
 {
   std::cout << "[PDG] Initializing ToasterSimuObjectReader" << std::endl;
   Reader<MovableObject>::init(node, param);
-  // ******************************************
-  // Starts listening to the joint_states
+  if (activated_)
+    subscribe();
+}
+
+void ToasterSimuObjectReader::subscribe()
+{
+  // Starts listening to the topic
   sub_ = node_->subscribe("/toaster_simu/objectList", 1, &ToasterSimuObjectReader::objectStateCallBack, this);
 }
 
+void ToasterSimuObjectReader::unsubscribe()
+{
+  sub_.shutdown();
+}
+
 void ToasterSimuObjectReader::objectStateCallBack(const toaster_msgs::ObjectListStamped::ConstPtr& msg) {
     //std::cout << "[area_manager][DEBUG] new data for object received" << std::endl;
   if(activated_)
@@ -38,7 +48,6 @@ void ToasterSimuObjectReader::objectStateCallBack(const toaster_msgs::ObjectList
             increaseNbObjects();
         } else
             curObject = globalLastConfig_[msg->objectList[i].meEntity.id];
-        lastConfigMutex_.unlock();
 
         std::vector<double> objOrientation;
         bg::model::point<double, 3, bg::cs::cartesian> objPosition;
@@ -63,12 +72,11 @@ void ToasterSimuObjectReader::objectStateCallBack(const toaster_msgs::ObjectList
         objOrientation.push_back(yaw);
         curObject->setOrientation(objOrientation);
 
-        lastConfigMutex_.lock();
         if (globalLastConfig_[msg->objectList[i].meEntity.id] == NULL)
             globalLastConfig_[curObject->getId()] = curObject;
-        lastConfigMutex_.unlock();
         if (lastConfig_[msg->objectList[i].meEntity.id] == NULL)
             lastConfig_[curObject->getId()] = curObject;
+        lastConfigMutex_.unlock();
     }
   }
 }
@@ -17,15 +17,27 @@ void ToasterSimuRobotReader::init(ros::NodeHandle* node, std::string param) {
   std::cout << "[PDG] Initializing ToasterSimuRobotReader" << std::endl;
   Reader<Robot>::init(node, param);
 
+  if (activated_)
+    subscribe();
+}
+
+void ToasterSimuRobotReader::subscribe()
+{
   if (fullRobot_)
       sub_ = node_->subscribe("/toaster_simu/robotList", 1, &ToasterSimuRobotReader::robotJointStateCallBack, this);
 }
 
+void ToasterSimuRobotReader::unsubscribe()
+{
+  sub_.shutdown();
+}
+
 void ToasterSimuRobotReader::robotJointStateCallBack(const toaster_msgs::RobotListStamped::ConstPtr& msg) {
     //std::cout << "[area_manager][DEBUG] new data for robot received" << std::endl;
 
     Robot* curRobot;
     double roll, pitch, yaw;
+    std::lock_guard<std::mutex> lock(configMutex());
     for (unsigned int i = 0; i < msg->robotList.size(); i++) {
 
         // If this robot is not assigned we have to allocate data.
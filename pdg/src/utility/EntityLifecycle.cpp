@@ -0,0 +1,91 @@
+/*
+ * File:   EntityLifecycle.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "pdg/utility/EntityLifecycle.h"
+
+EntityLifecycle::EntityLifecycle() {
+    staleTime_ = 1000000000;
+    evictTime_ = 0;
+}
+
+void EntityLifecycle::setTimes(uint64_t staleTime, uint64_t evictTime) {
+    staleTime_ = staleTime;
+    evictTime_ = evictTime;
+}
+
+void EntityLifecycle::seen(const std::string& id, uint64_t time, uint64_t now) {
+    std::map<std::string, entity_t>::iterator it = entities_.find(id);
+    if (it == entities_.end()) {
+        entity_t entity;
+        entity.time = time;
+        entity.live = false;
+        entity.deadline = deadlines_.end();
+        it = entities_.insert(std::make_pair(id, entity)).first;
+    } else if (it->second.time == time)
+        return;
+
+    entity_t& entity = it->second;
+    entity.time = time;
+    if (entity.deadline != deadlines_.end()) {
+        deadlines_.erase(entity.deadline);
+        entity.deadline = deadlines_.end();
+    }
+
+    if (time + staleTime_ > now) {
+        if (!entity.live) {
+            entity.live = true;
+            addEvent(id, toaster_msgs::EntityEvent::APPEAR, time);
+        }
+        entity.deadline = deadlines_.insert(std::make_pair(time + staleTime_, id));
+    } else {
+        // Updated with an old time
+        if (entity.live) {
+            entity.live = false;
+            addEvent(id, toaster_msgs::EntityEvent::DISAPPEAR, now);
+        }
+        if (evictTime_ > 0)
+            entity.deadline = deadlines_.insert(std::make_pair(time + staleTime_ + evictTime_, id));
+    }
+}
+
+void EntityLifecycle::update(uint64_t now, std::vector<std::string>& evicted) {
+    while (!deadlines_.empty() && deadlines_.begin()->first <= now) {
+        std::string id = deadlines_.begin()->second;
+        deadlines_.erase(deadlines_.begin());
+
+        std::map<std::string, entity_t>::iterator it = entities_.find(id);
+        entity_t& entity = it->second;
+        entity.deadline = deadlines_.end();
+
+        if (entity.live) {
+            entity.live = false;
+            addEvent(id, toaster_msgs::EntityEvent::DISAPPEAR, now);
+            if (evictTime_ > 0)
+                entity.deadline = deadlines_.insert(std::make_pair(entity.time + staleTime_ + evictTime_, id));
+        } else {
+            evicted.push_back(id);
+            entities_.erase(it);
+        }
+    }
+}
+
+bool EntityLifecycle::isLive(const std::string& id) const {
+    std::map<std::string, entity_t>::const_iterator it = entities_.find(id);
+    return it != entities_.end() && it->second.live;
+}
+
+void EntityLifecycle::takeEvents(std::vector<toaster_msgs::EntityEvent>& events) {
+    events.insert(events.end(), events_.begin(), events_.end());
+    events_.clear();
+}
+
+void EntityLifecycle::addEvent(const std::string& id, unsigned char transition, uint64_t time) {
+    toaster_msgs::EntityEvent event;
+    event.entityId = id;
+    event.transition = transition;
+    event.time = time;
+    events_.push_back(event);
+}
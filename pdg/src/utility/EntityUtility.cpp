@@ -3,11 +3,91 @@
 //tf
 #include <tf/transform_broadcaster.h>
 
-ros::ServiceClient* setPoseClient_;
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// toaster_simu is called by a thread of its own, so the main loop is not
+// blocked by a slow or restarting toaster_simu
+static ros::NodeHandle* setPoseNode_ = NULL;
+static std::string setPoseService_;
+static ros::ServiceClient setPoseClient_;
+static std::thread setPoseThread_;
+static std::mutex setPoseMutex_;
+static std::condition_variable setPoseCondition_;
+static bool setPoseStop_ = false;
+
+// Poses given by sendToasterSimu and not sent yet, the last one of each entity
+static toaster_msgs::SetEntitiesPose pendingPoses_;
+static std::map<std::string, unsigned int> pendingIndex_;
+
+// A client is created again at most once a second while toaster_simu is down
+static const std::chrono::seconds setPoseRetryPeriod_(1);
+
+static void sendPoses()
+{
+  toaster_msgs::SetEntitiesPose setPoses;
+  std::chrono::steady_clock::time_point lastConnection = std::chrono::steady_clock::now() - setPoseRetryPeriod_;
+
+  std::unique_lock<std::mutex> lock(setPoseMutex_);
+  while (!setPoseStop_)
+  {
+    if (pendingPoses_.request.id.empty())
+    {
+      setPoseCondition_.wait(lock);
+      continue;
+    }
+
+    // The persistent client is no longer valid once toaster_simu stopped
+    if (!setPoseClient_.isValid())
+    {
+      std::chrono::steady_clock::time_point retry = lastConnection + setPoseRetryPeriod_;
+      if (std::chrono::steady_clock::now() < retry)
+      {
+        setPoseCondition_.wait_until(lock, retry);
+        continue;
+      }
+      lastConnection = std::chrono::steady_clock::now();
+      setPoseClient_ = setPoseNode_->serviceClient<toaster_msgs::SetEntitiesPose>(setPoseService_, true);
+    }
+
+    std::swap(setPoses.request, pendingPoses_.request);
+    pendingPoses_.request = toaster_msgs::SetEntitiesPose::Request();
+    pendingIndex_.clear();
+
+    lock.unlock();
+    bool sent = setPoseClient_.call(setPoses);
+    lock.lock();
+
+    if (sent)
+      ROS_DEBUG("[Request] we request to set %lu poses in toaster_simu\n", setPoses.request.id.size());
+    else
+    {
+      ROS_INFO("[Request] we failed to request to set %lu poses in toaster_simu\n", setPoses.request.id.size());
+      setPoseClient_.shutdown();
+    }
+  }
+}
 
-void EntityUtility_setClient(ros::ServiceClient* m_setPoseClient)
+void EntityUtility_setClient(ros::NodeHandle* node, const std::string& service)
 {
-  setPoseClient_ = m_setPoseClient;
+  setPoseNode_ = node;
+  setPoseService_ = service;
+  setPoseStop_ = false;
+  setPoseThread_ = std::thread(sendPoses);
+}
+
+void EntityUtility_closeClient()
+{
+  {
+    std::lock_guard<std::mutex> lock(setPoseMutex_);
+    setPoseStop_ = true;
+  }
+  setPoseCondition_.notify_one();
+  if (setPoseThread_.joinable())
+    setPoseThread_.join();
+  setPoseClient_.shutdown();
 }
 
 void fillValue(MovableObject* srcObject, toaster_msgs::Object& msgObject) {
@@ -31,127 +111,210 @@ void fillEntity(Entity* srcEntity, toaster_msgs::Entity& msgEntity) {
     msgEntity.pose.orientation.w = q[3];
 }
 
-void updateEntity(Entity& newPoseEnt, Entity* storedEntity) {
-    //ROS_INFO("UPDATE entity");
-    storedEntity->position_ = newPoseEnt.getPosition();
-    storedEntity->orientation_ = newPoseEnt.getOrientation();
-    storedEntity->setTime(newPoseEnt.getTime());
+void fillEntity(Entity* srcEntity, toaster_msgs::Entity& msgEntity, orientationCache_t& cache) {
+    msgEntity.id = srcEntity->getId();
+    msgEntity.time = srcEntity->getTime();
+    msgEntity.name = srcEntity->getName();
+    msgEntity.pose.position.x = srcEntity->position_.get<0>();
+    msgEntity.pose.position.y = srcEntity->position_.get<1>();
+    msgEntity.pose.position.z = srcEntity->position_.get<2>();
+
+    const std::vector<double>& orientation = srcEntity->orientation_;
+    if (orientation[0] != cache.rpy[0] || orientation[1] != cache.rpy[1] || orientation[2] != cache.rpy[2]) {
+        tf::Quaternion q;
+        q.setRPY(orientation[0], orientation[1], orientation[2]);
+
+        cache.quaternion.x = q[0];
+        cache.quaternion.y = q[1];
+        cache.quaternion.z = q[2];
+        cache.quaternion.w = q[3];
+        cache.rpy[0] = orientation[0];
+        cache.rpy[1] = orientation[1];
+        cache.rpy[2] = orientation[2];
+    }
+    msgEntity.pose.orientation = cache.quaternion;
 }
 
-bool updateToasterSimu(Entity* storedEntity, std::string type) {
-    toaster_msgs::SetEntityPose setPose;
-    setPose.request.id = storedEntity->getId();
-    setPose.request.type = type;
-    setPose.request.pose.position.x = storedEntity->position_.get<0>();
-    setPose.request.pose.position.y = storedEntity->position_.get<1>();
-    setPose.request.pose.position.z = storedEntity->position_.get<2>();
-
-
-    tf::Quaternion q;
-    q.setRPY(storedEntity->getOrientation()[0], storedEntity->getOrientation()[1], storedEntity->getOrientation()[2]);
+void fillSkeleton(std::map<std::string, Joint*>& skeleton, const std::string& agentId,
+        toaster_msgs::Agent& msgAgent, agentCache_t& cache, bool jointPosition) {
+    msgAgent.skeletonNames.resize(skeleton.size());
+    msgAgent.skeletonJoint.resize(skeleton.size());
+    cache.joints.resize(skeleton.size());
+
+    unsigned int i = 0;
+    for (std::map<std::string, Joint*>::iterator itJoint = skeleton.begin(); itJoint != skeleton.end(); ++itJoint, ++i) {
+        toaster_msgs::Joint& joint_msg = msgAgent.skeletonJoint[i];
+        msgAgent.skeletonNames[i] = itJoint->first;
+        fillEntity(itJoint->second, joint_msg.meEntity, cache.joints[i]);
+        joint_msg.jointOwner = agentId;
+        joint_msg.position = jointPosition ? itJoint->second->position : 0.0;
+    }
+}
 
-    setPose.request.pose.orientation.x = q[0];
-    setPose.request.pose.orientation.y = q[1];
-    setPose.request.pose.orientation.z = q[2];
-    setPose.request.pose.orientation.w = q[3];
+// The fact is reset, strings keep their storage
+toaster_msgs::Fact& nextFactMsg(struct toasterList_t& list_msg) {
+    if (list_msg.nbFacts == list_msg.fact_msg.factList.size())
+        list_msg.fact_msg.factList.push_back(toaster_msgs::Fact());
+    toaster_msgs::Fact& fact_msg = list_msg.fact_msg.factList[list_msg.nbFacts++];
+
+    fact_msg.property.clear();
+    fact_msg.propertyType.clear();
+    fact_msg.subProperty.clear();
+    fact_msg.subjectId.clear();
+    fact_msg.targetId.clear();
+    fact_msg.subjectOwnerId.clear();
+    fact_msg.targetOwnerId.clear();
+    fact_msg.valueType = 0;
+    fact_msg.factObservability = 0.0;
+    fact_msg.doubleValue = 0.0;
+    fact_msg.stringValue.clear();
+    fact_msg.confidence = 0.0;
+    fact_msg.time = 0;
+    fact_msg.timeStart = 0;
+    fact_msg.timeEnd = 0;
+    return fact_msg;
+}
 
-    if (setPoseClient_->call(setPose)) {
-        ROS_DEBUG("[Request] we request to set Pose in toaster_simu: %s \n", storedEntity->getId().c_str());
-        return true;
-    } else {
-        ROS_INFO("[Request] we failed to request to set Pose in toaster_simu: %s\n", storedEntity->getId().c_str());
-        return false;
+toaster_msgs::Object& nextObjectMsg(struct toasterList_t& list_msg, orientationCache_t*& cache) {
+    if (list_msg.nbObjects == list_msg.object_msg.objectList.size()) {
+        list_msg.object_msg.objectList.push_back(toaster_msgs::Object());
+        list_msg.objectCache.resize(list_msg.object_msg.objectList.size());
     }
+    cache = &list_msg.objectCache[list_msg.nbObjects];
+    return list_msg.object_msg.objectList[list_msg.nbObjects++];
 }
 
-bool putAtJointPosition(Entity* storedEntity, std::string agentId, std::string joint,
-        toaster_msgs::HumanListStamped& humanList_msg, bool toastersimu) {
-
-    toaster_msgs::Entity jointEntity;
+// Objects in hand are added by putAtJointPosition during the publication
+void clearAgentMsg(toaster_msgs::Agent& msgAgent) {
+    msgAgent.hasObjects.clear();
+    msgAgent.busyHands.clear();
+}
 
-    //  find back the agent:
-    for (std::vector<toaster_msgs::Human>::iterator itAgent = humanList_msg.humanList.begin(); itAgent != humanList_msg.humanList.end(); ++itAgent) {
-        if ((*itAgent).meAgent.meEntity.id == agentId) {
+toaster_msgs::Human& nextHumanMsg(struct toasterList_t& list_msg, agentCache_t*& cache) {
+    if (list_msg.nbHumans == list_msg.human_msg.humanList.size()) {
+        list_msg.human_msg.humanList.push_back(toaster_msgs::Human());
+        list_msg.humanCache.resize(list_msg.human_msg.humanList.size());
+    }
+    cache = &list_msg.humanCache[list_msg.nbHumans];
+    toaster_msgs::Human& human_msg = list_msg.human_msg.humanList[list_msg.nbHumans++];
+    clearAgentMsg(human_msg.meAgent);
+    return human_msg;
+}
 
-            //Find back the joint
-            std::vector<std::string>::iterator it = std::find((*itAgent).meAgent.skeletonNames.begin(),
-                    (*itAgent).meAgent.skeletonNames.end(), joint);
+toaster_msgs::Robot& nextRobotMsg(struct toasterList_t& list_msg, agentCache_t*& cache) {
+    if (list_msg.nbRobots == list_msg.robot_msg.robotList.size()) {
+        list_msg.robot_msg.robotList.push_back(toaster_msgs::Robot());
+        list_msg.robotCache.resize(list_msg.robot_msg.robotList.size());
+    }
+    cache = &list_msg.robotCache[list_msg.nbRobots];
+    toaster_msgs::Robot& robot_msg = list_msg.robot_msg.robotList[list_msg.nbRobots++];
+    clearAgentMsg(robot_msg.meAgent);
+    return robot_msg;
+}
 
-            if (it != (*itAgent).meAgent.skeletonNames.end()) {
-                jointEntity = (*itAgent).meAgent.skeletonJoint[std::distance((*itAgent).meAgent.skeletonNames.begin(), it)].meEntity;
+void updateEntity(Entity& newPoseEnt, Entity* storedEntity) {
+    //ROS_INFO("UPDATE entity");
+    storedEntity->position_ = newPoseEnt.getPosition();
+    storedEntity->orientation_ = newPoseEnt.getOrientation();
+    storedEntity->setTime(newPoseEnt.getTime());
+}
 
-                storedEntity->position_.set<0>(jointEntity.pose.position.x);
-                storedEntity->position_.set<1>(jointEntity.pose.position.y);
-                storedEntity->position_.set<2>(jointEntity.pose.position.z);
+// Poses waiting to be sent to toaster_simu by sendToasterSimu
+static toaster_msgs::SetEntitiesPose toasterSimuPoses_;
 
-                tf::Quaternion q(jointEntity.pose.orientation.x, jointEntity.pose.orientation.y, jointEntity.pose.orientation.z, jointEntity.pose.orientation.w);
-                double roll, pitch, yaw;
-                tf::Matrix3x3 m(q);
-                m.getEulerYPR(yaw, pitch, roll);
+bool updateToasterSimu(Entity* storedEntity, std::string type) {
+    geometry_msgs::Pose pose;
+    pose.position.x = storedEntity->position_.get<0>();
+    pose.position.y = storedEntity->position_.get<1>();
+    pose.position.z = storedEntity->position_.get<2>();
 
 
-                storedEntity->orientation_[0] = roll;
-                storedEntity->orientation_[1] = pitch;
-                storedEntity->orientation_[2] = yaw;
+    tf::Quaternion q;
+    q.setRPY(storedEntity->getOrientation()[0], storedEntity->getOrientation()[1], storedEntity->getOrientation()[2]);
 
-                storedEntity->setTime(jointEntity.time);
+    pose.orientation.x = q[0];
+    pose.orientation.y = q[1];
+    pose.orientation.z = q[2];
+    pose.orientation.w = q[3];
 
-                (*itAgent).meAgent.hasObjects.push_back(storedEntity->getId());
-                (*itAgent).meAgent.busyHands.push_back(jointEntity.id);
+    toasterSimuPoses_.request.id.push_back(storedEntity->getId());
+    toasterSimuPoses_.request.ownerId.push_back("");
+    toasterSimuPoses_.request.type.push_back(type);
+    toasterSimuPoses_.request.pose.push_back(pose);
+    return true;
+}
 
-                if (toastersimu)
-                    updateToasterSimu(storedEntity, "object");
+bool sendToasterSimu() {
+    toaster_msgs::SetEntitiesPose::Request& request = toasterSimuPoses_.request;
+    if (request.id.empty())
+        return true;
 
-                return true;
-            } else
-                ROS_WARN("Can't find joint %s for human %s. Couldn't attach object %s to this joint", joint.c_str(), agentId.c_str(), storedEntity->getId().c_str());
+    // Poses not sent yet are replaced by the new ones of the same entities
+    {
+        std::lock_guard<std::mutex> lock(setPoseMutex_);
+        toaster_msgs::SetEntitiesPose::Request& pending = pendingPoses_.request;
+        for (unsigned int i = 0; i < request.id.size(); i++) {
+            std::map<std::string, unsigned int>::iterator it = pendingIndex_.find(request.id[i]);
+            if (it == pendingIndex_.end()) {
+                pendingIndex_[request.id[i]] = pending.id.size();
+                pending.id.push_back(request.id[i]);
+                pending.ownerId.push_back(request.ownerId[i]);
+                pending.type.push_back(request.type[i]);
+                pending.pose.push_back(request.pose[i]);
+            } else {
+                pending.ownerId[it->second] = request.ownerId[i];
+                pending.type[it->second] = request.type[i];
+                pending.pose[it->second] = request.pose[i];
+            }
         }
     }
-    return false;
-}
+    setPoseCondition_.notify_one();
 
-bool putAtJointPosition(Entity* storedEntity, std::string agentId, std::string joint,
-        toaster_msgs::RobotListStamped robotList_msg, bool toastersimu) {
+    request.id.clear();
+    request.ownerId.clear();
+    request.type.clear();
+    request.pose.clear();
+    return true;
+}
 
-    toaster_msgs::Entity jointEntity;
+bool putAtJointPosition(Entity* storedEntity, const std::string& agentId, const std::string& joint,
+        struct toasterList_t& list_msg, bool toastersimu) {
 
-    //  find back the agent:
-    for (std::vector<toaster_msgs::Robot>::iterator itAgent = robotList_msg.robotList.begin(); itAgent != robotList_msg.robotList.end(); ++itAgent) {
-        if ((*itAgent).meAgent.meEntity.id == agentId) {
+    //  find back the agent and the joint:
+    toaster_msgs::Agent* agent;
+    unsigned int jointIndex;
+    list_msg.findJoint(agentId, joint, agent, jointIndex);
+    if (agent == NULL)
+        return false;
 
-            //Find back the joint
-            std::vector<std::string>::iterator it = std::find((*itAgent).meAgent.skeletonNames.begin(),
-                    (*itAgent).meAgent.skeletonNames.end(), joint);
+    if (jointIndex >= agent->skeletonJoint.size()) {
+        ROS_WARN("Can't find joint %s for agent %s. Couldn't attach object %s to this joint", joint.c_str(), agentId.c_str(), storedEntity->getId().c_str());
+        return false;
+    }
 
-            if (it != (*itAgent).meAgent.skeletonNames.end()) {
-                jointEntity = (*itAgent).meAgent.skeletonJoint[std::distance((*itAgent).meAgent.skeletonNames.begin(), it)].meEntity;
+    const toaster_msgs::Entity& jointEntity = agent->skeletonJoint[jointIndex].meEntity;
 
-                storedEntity->position_.set<0>(jointEntity.pose.position.x);
-                storedEntity->position_.set<1>(jointEntity.pose.position.y);
-                storedEntity->position_.set<2>(jointEntity.pose.position.z);
+    storedEntity->position_.set<0>(jointEntity.pose.position.x);
+    storedEntity->position_.set<1>(jointEntity.pose.position.y);
+    storedEntity->position_.set<2>(jointEntity.pose.position.z);
 
-                storedEntity->setTime(jointEntity.time);
+    tf::Quaternion q(jointEntity.pose.orientation.x, jointEntity.pose.orientation.y, jointEntity.pose.orientation.z, jointEntity.pose.orientation.w);
+    double roll, pitch, yaw;
+    tf::Matrix3x3 m(q);
+    m.getEulerYPR(yaw, pitch, roll);
 
-                tf::Quaternion q(jointEntity.pose.orientation.x, jointEntity.pose.orientation.y, jointEntity.pose.orientation.z, jointEntity.pose.orientation.w);
-                double roll, pitch, yaw;
-                tf::Matrix3x3 m(q);
-                m.getEulerYPR(yaw, pitch, roll);
 
+    storedEntity->orientation_[0] = roll;
+    storedEntity->orientation_[1] = pitch;
+    storedEntity->orientation_[2] = yaw;
 
-                storedEntity->orientation_[0] = roll;
-                storedEntity->orientation_[1] = pitch;
-                storedEntity->orientation_[2] = yaw;
+    storedEntity->setTime(jointEntity.time);
 
-                (*itAgent).meAgent.hasObjects.push_back(storedEntity->getId());
-                (*itAgent).meAgent.busyHands.push_back(jointEntity.id);
+    agent->hasObjects.push_back(storedEntity->getId());
+    agent->busyHands.push_back(jointEntity.id);
 
-                if (toastersimu)
-                    updateToasterSimu(storedEntity, "object");
+    if (toastersimu)
+        updateToasterSimu(storedEntity, "object");
 
-                return true;
-            } else
-                ROS_WARN("Can't find joint %s for robot %s. Couldn't attach object %s to this joint", joint.c_str(), agentId.c_str(), storedEntity->getId().c_str());
-        }
-    }
-    return false;
+    return true;
 }
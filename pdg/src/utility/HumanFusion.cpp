@@ -0,0 +1,214 @@
+/*
+ * File:   HumanFusion.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "pdg/utility/HumanFusion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+HumanFusion::HumanFusion() {
+    gate_ = 0.5;
+    maxExtrapolation_ = 0.2;
+}
+
+void HumanFusion::updateTrack(track_t& track, const toaster_msgs::Entity& entity) {
+    if (entity.time == track.last.time)
+        return;
+
+    track.prev = track.last;
+    track.hasPrev = track.last.time != 0;
+    track.last.time = entity.time;
+    track.last.position[0] = entity.pose.position.x;
+    track.last.position[1] = entity.pose.position.y;
+    track.last.position[2] = entity.pose.position.z;
+}
+
+void HumanFusion::position(const track_t& track, uint64_t time, double position[3]) const {
+    for (unsigned int i = 0; i < 3; i++)
+        position[i] = track.last.position[i];
+
+    if (!track.hasPrev || track.last.time <= track.prev.time)
+        return;
+
+    // Interpolated between the two samples, extrapolated after the last one
+    double span = (track.last.time - track.prev.time) / 1e9;
+    double dt = ((double) time - (double) track.last.time) / 1e9;
+    dt = std::max(-span, std::min(dt, maxExtrapolation_));
+
+    for (unsigned int i = 0; i < 3; i++)
+        position[i] += (track.last.position[i] - track.prev.position[i]) / span * dt;
+}
+
+unsigned int HumanFusion::findGroup(std::vector<unsigned int>& groups, unsigned int i) const {
+    while (groups[i] != i) {
+        groups[i] = groups[groups[i]];
+        i = groups[i];
+    }
+    return i;
+}
+
+void HumanFusion::fuse(struct toasterList_t& list_msg, const std::vector<unsigned int>& sourcesEnd, uint64_t time) {
+    std::vector<toaster_msgs::Human>& humans = list_msg.human_msg.humanList;
+    unsigned int nbHumans = list_msg.nbHumans;
+
+    std::vector<unsigned int> sources(nbHumans);
+    std::vector<double> positions(3 * nbHumans);
+    std::vector<track_t*> tracks(nbHumans);
+
+    std::set<trackKey_t> published;
+    unsigned int source = 0;
+    for (unsigned int i = 0; i < nbHumans; i++) {
+        while (source < sourcesEnd.size() && i >= sourcesEnd[source])
+            source++;
+        sources[i] = source;
+
+        const toaster_msgs::Entity& entity = humans[i].meAgent.meEntity;
+        trackKey_t key(source, entity.id);
+        std::map<trackKey_t, track_t>::iterator it = tracks_.find(key);
+        if (it == tracks_.end()) {
+            track_t track;
+            track.last.time = 0;
+            track.hasPrev = false;
+            it = tracks_.insert(std::make_pair(key, track)).first;
+        }
+        updateTrack(it->second, entity);
+        position(it->second, time, &positions[3 * i]);
+        tracks[i] = &it->second;
+        published.insert(key);
+    }
+
+    // Tracks a source does not publish anymore are forgotten
+    for (std::map<trackKey_t, track_t>::iterator it = tracks_.begin(); it != tracks_.end();) {
+        if (published.find(it->first) == published.end())
+            tracks_.erase(it++);
+        else
+            ++it;
+    }
+
+    // Pairs of tracks of different sources inside the gate, nearest first
+    std::vector<pair_t> pairs;
+    for (unsigned int i = 0; i < nbHumans; i++) {
+        for (unsigned int j = i + 1; j < nbHumans; j++) {
+            if (sources[i] == sources[j])
+                continue;
+
+            double dx = positions[3 * i] - positions[3 * j];
+            double dy = positions[3 * i + 1] - positions[3 * j + 1];
+            double dz = positions[3 * i + 2] - positions[3 * j + 2];
+            double dist = sqrt(dx * dx + dy * dy + dz * dz);
+
+            bool linked = !tracks[i]->fusedId.empty() && tracks[i]->fusedId == tracks[j]->fusedId;
+            if (dist < (linked ? 1.5 * gate_ : gate_)) {
+                pair_t pair;
+                pair.cost = linked ? 0.5 * dist : dist;
+                pair.first = i;
+                pair.second = j;
+                pairs.push_back(pair);
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    // Groups get at most one track per source
+    std::vector<unsigned int> groups(nbHumans);
+    std::vector<std::set<unsigned int> > groupsSources(nbHumans);
+    for (unsigned int i = 0; i < nbHumans; i++) {
+        groups[i] = i;
+        groupsSources[i].insert(sources[i]);
+    }
+
+    for (unsigned int p = 0; p < pairs.size(); p++) {
+        unsigned int first = findGroup(groups, pairs[p].first);
+        unsigned int second = findGroup(groups, pairs[p].second);
+        if (first == second)
+            continue;
+
+        bool sharedSource = false;
+        for (std::set<unsigned int>::iterator it = groupsSources[second].begin(); it != groupsSources[second].end(); ++it)
+            if (groupsSources[first].count(*it))
+                sharedSource = true;
+        if (sharedSource)
+            continue;
+
+        groups[second] = first;
+        groupsSources[first].insert(groupsSources[second].begin(), groupsSources[second].end());
+    }
+
+    std::map<unsigned int, std::vector<unsigned int> > members;
+    for (unsigned int i = 0; i < nbHumans; i++)
+        members[findGroup(groups, i)].push_back(i);
+
+    // Each group is published by one of its humans, the one which gave the
+    // group id last time if any, otherwise the one of the first source
+    std::vector<bool> kept(nbHumans, false);
+    std::set<std::string> removed;
+    for (std::map<unsigned int, std::vector<unsigned int> >::iterator it = members.begin(); it != members.end(); ++it) {
+        std::vector<unsigned int>& group = it->second;
+
+        unsigned int primary = group[0];
+        for (unsigned int m = 0; m < group.size(); m++)
+            for (unsigned int n = 0; n < group.size(); n++)
+                if (tracks[group[n]]->fusedId == humans[group[m]].meAgent.meEntity.id)
+                    primary = group[m];
+
+        double mean[3] = {0.0, 0.0, 0.0};
+        for (unsigned int m = 0; m < group.size(); m++)
+            for (unsigned int k = 0; k < 3; k++)
+                mean[k] += positions[3 * group[m] + k] / group.size();
+
+        toaster_msgs::Agent& agent = humans[primary].meAgent;
+        double delta[3] = {mean[0] - agent.meEntity.pose.position.x,
+                           mean[1] - agent.meEntity.pose.position.y,
+                           mean[2] - agent.meEntity.pose.position.z};
+
+        agent.meEntity.pose.position.x = mean[0];
+        agent.meEntity.pose.position.y = mean[1];
+        agent.meEntity.pose.position.z = mean[2];
+        agent.meEntity.time = time;
+        for (unsigned int j = 0; j < agent.skeletonJoint.size(); j++) {
+            geometry_msgs::Point& jointPosition = agent.skeletonJoint[j].meEntity.pose.position;
+            jointPosition.x += delta[0];
+            jointPosition.y += delta[1];
+            jointPosition.z += delta[2];
+        }
+
+        kept[primary] = true;
+        for (unsigned int m = 0; m < group.size(); m++) {
+            tracks[group[m]]->fusedId = agent.meEntity.id;
+            // The id of the group is kept, even if another source also gave it
+            if (group[m] != primary && humans[group[m]].meAgent.meEntity.id != agent.meEntity.id)
+                removed.insert(humans[group[m]].meAgent.meEntity.id);
+        }
+    }
+
+    if (removed.empty())
+        return;
+
+    // Removed humans are moved after the last human of the list, with their cache
+    unsigned int nbKept = 0;
+    for (unsigned int i = 0; i < nbHumans; i++) {
+        if (!kept[i])
+            continue;
+        if (i != nbKept) {
+            std::swap(humans[i], humans[nbKept]);
+            std::swap(list_msg.humanCache[i], list_msg.humanCache[nbKept]);
+        }
+        nbKept++;
+    }
+    list_msg.nbHumans = nbKept;
+
+    std::vector<toaster_msgs::Fact>& facts = list_msg.fact_msg.factList;
+    unsigned int nbFacts = 0;
+    for (unsigned int i = 0; i < list_msg.nbFacts; i++) {
+        if (facts[i].property == "isPresent" && removed.count(facts[i].subjectId))
+            continue;
+        if (i != nbFacts)
+            std::swap(facts[i], facts[nbFacts]);
+        nbFacts++;
+    }
+    list_msg.nbFacts = nbFacts;
+}
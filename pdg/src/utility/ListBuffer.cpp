@@ -0,0 +1,71 @@
+/*
+ * File:   ListBuffer.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "pdg/utility/ListBuffer.h"
+
+void toasterList_t::clear() {
+    nbObjects = 0;
+    nbHumans = 0;
+    nbRobots = 0;
+    nbFacts = 0;
+    entityEvents.clear();
+}
+
+void toasterList_t::finishAgents() {
+    human_msg.humanList.resize(nbHumans);
+    humanCache.resize(nbHumans);
+    robot_msg.robotList.resize(nbRobots);
+    robotCache.resize(nbRobots);
+
+    publication++;
+    for (unsigned int i = 0; i < nbHumans; i++)
+        indexAgent(human_msg.humanList[i].meAgent);
+    for (unsigned int i = 0; i < nbRobots; i++)
+        indexAgent(robot_msg.robotList[i].meAgent);
+
+    for (std::map<std::string, agentIndex_t>::iterator it = agentIndex.begin(); it != agentIndex.end();) {
+        if (it->second.publication != publication)
+            agentIndex.erase(it++);
+        else
+            ++it;
+    }
+}
+
+void toasterList_t::findJoint(const std::string& agentId, const std::string& joint,
+        toaster_msgs::Agent*& agent, unsigned int& jointIndex) {
+    agent = nullptr;
+    std::map<std::string, agentIndex_t>::iterator itAgent = agentIndex.find(agentId);
+    if (itAgent == agentIndex.end())
+        return;
+
+    agent = itAgent->second.agent;
+    std::map<std::string, unsigned int>::iterator itJoint = itAgent->second.joints.find(joint);
+    jointIndex = itJoint == itAgent->second.joints.end() ? agent->skeletonJoint.size() : itJoint->second;
+}
+
+void toasterList_t::finish() {
+    finishAgents();
+    object_msg.objectList.resize(nbObjects);
+    objectCache.resize(nbObjects);
+    fact_msg.factList.resize(nbFacts);
+}
+
+void toasterList_t::indexAgent(toaster_msgs::Agent& agent) {
+    agentIndex_t& index = agentIndex[agent.meEntity.id];
+    if (index.publication == publication)
+        return;
+
+    index.agent = &agent;
+    index.publication = publication;
+
+    // Joints are indexed again only if the skeleton changed
+    if (index.skeletonNames != agent.skeletonNames) {
+        index.skeletonNames = agent.skeletonNames;
+        index.joints.clear();
+        for (unsigned int i = 0; i < agent.skeletonNames.size() && i < agent.skeletonJoint.size(); i++)
+            index.joints.insert(std::make_pair(agent.skeletonNames[i], i));
+    }
+}
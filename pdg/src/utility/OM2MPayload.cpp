@@ -0,0 +1,109 @@
+/*
+ * File:   OM2MPayload.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "pdg/utility/OM2MPayload.h"
+
+#include <cstring>
+
+static const char* const payloadKeys_[] = {"type=", "data=", "unit=", "color="};
+static const size_t payloadKeysLength_[] = {5, 5, 5, 6};
+static const unsigned int nbPayloadKeys_ = 4;
+
+// Only the '=' ending a key and the ' ' starting a " /" need to be looked at
+bool readPayloadLine(boost::string_ref line, payloadLine_t& fields)
+{
+  boost::string_ref* values[nbPayloadKeys_] = {&fields.type, &fields.data, &fields.unit, &fields.color};
+  size_t valuesStart[nbPayloadKeys_];
+  bool found[nbPayloadKeys_];
+  bool closed[nbPayloadKeys_];
+  for (unsigned int k = 0; k < nbPayloadKeys_; k++)
+  {
+    found[k] = false;
+    closed[k] = false;
+    *values[k] = boost::string_ref();
+  }
+
+  const char* data = line.data();
+  size_t size = line.size();
+  size_t namePos = boost::string_ref::npos;
+  for (size_t i = 0; i < size; i++)
+  {
+    char c = data[i];
+    if (c == '=')
+    {
+      if (namePos == boost::string_ref::npos)
+        namePos = i;
+
+      for (unsigned int k = 0; k < nbPayloadKeys_; k++)
+        if (!found[k] && (i + 1 >= payloadKeysLength_[k])
+            && (memcmp(data + i + 1 - payloadKeysLength_[k], payloadKeys_[k], payloadKeysLength_[k]) == 0))
+        {
+          found[k] = true;
+          valuesStart[k] = i + 1;
+        }
+    }
+    else if ((c == ' ') && (i + 1 < size) && (data[i + 1] == '/'))
+    {
+      for (unsigned int k = 0; k < nbPayloadKeys_; k++)
+        if (found[k] && !closed[k])
+        {
+          *values[k] = line.substr(valuesStart[k], i - valuesStart[k]);
+          closed[k] = true;
+        }
+    }
+  }
+
+  if (namePos == boost::string_ref::npos)
+    return false;
+
+  for (unsigned int k = 0; k < nbPayloadKeys_; k++)
+    if (found[k] && !closed[k])
+      *values[k] = line.substr(valuesStart[k]);
+
+  fields.name = line.substr(0, namePos);
+  return true;
+}
+
+void readPreFacts(boost::string_ref content, std::vector<struct preFact_t>& preFacts)
+{
+  preFacts.clear();
+  payloadLine_t fields;
+
+  // Only lines ended by a new line are read
+  size_t stop_pos;
+  while ((stop_pos = content.find('\n')) != boost::string_ref::npos)
+  {
+    boost::string_ref data = content.substr(0, stop_pos);
+    content.remove_prefix(stop_pos + 1);
+
+    if (!readPayloadLine(data, fields)) // if not valid data
+      continue;
+
+    struct preFact_t preFact;
+    if(fields.name != "DATA")
+      preFact.type = fields.name.to_string();
+    else
+      preFact.type = fields.type.to_string();
+
+    if(fields.data == "true")
+      preFact.data = "active";
+    else if(fields.data == "false")
+      preFact.data = "inactive";
+    else
+      preFact.data = fields.data.to_string();
+
+    if((!fields.unit.empty()) && (data != "true") && (data != "false"))
+      preFact.objectType = sensor;
+    else
+      preFact.objectType = other;
+
+    if((!fields.color.empty()) && (preFact.type.find("LAMP") != std::string::npos))
+      preFact.param = fields.color.to_string();
+
+    if(preFact.type != "")
+      preFacts.push_back(preFact);
+  }
+}
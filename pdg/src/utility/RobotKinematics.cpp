@@ -0,0 +1,127 @@
+/*
+ * File:   RobotKinematics.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "pdg/utility/RobotKinematics.h"
+
+#include "ros/ros.h"
+#include <urdf/model.h>
+
+RobotKinematics::RobotKinematics() {
+    loaded_ = false;
+}
+
+bool RobotKinematics::load(const std::string& param) {
+    urdf::Model model;
+    if (!model.initParam(param)) {
+        ROS_WARN("[PDG] Could not load the robot description from %s", param.c_str());
+        return false;
+    }
+
+    chain_.clear();
+    jointIndex_.clear();
+    linkIndex_.clear();
+    msgNames_.clear();
+    msgIndex_.clear();
+
+    rootLink_ = model.getRoot()->name;
+    linkIndex_[rootLink_] = 0;
+
+    // Breadth first from the root: parents are placed before their children
+    std::vector<std::string> links;
+    links.push_back(rootLink_);
+    for (unsigned int i = 0; i < links.size(); i++) {
+        auto link = model.getLink(links[i]);
+        for (unsigned int j = 0; j < link->child_joints.size(); j++) {
+            auto joint = link->child_joints[j];
+            const urdf::Pose& origin = joint->parent_to_joint_origin_transform;
+
+            chainJoint_t chainJoint;
+            chainJoint.parent = i;
+            chainJoint.child = links.size();
+            chainJoint.origin.setOrigin(tf::Vector3(origin.position.x, origin.position.y, origin.position.z));
+            chainJoint.origin.setRotation(tf::Quaternion(origin.rotation.x, origin.rotation.y,
+                    origin.rotation.z, origin.rotation.w));
+            chainJoint.axis = tf::Vector3(joint->axis.x, joint->axis.y, joint->axis.z);
+
+            if (joint->type == urdf::Joint::REVOLUTE || joint->type == urdf::Joint::CONTINUOUS)
+                chainJoint.type = REVOLUTE;
+            else if (joint->type == urdf::Joint::PRISMATIC)
+                chainJoint.type = PRISMATIC;
+            else
+                chainJoint.type = FIXED;
+
+            chainJoint.mimic = -1;
+            chainJoint.multiplier = 1.0;
+            chainJoint.offset = 0.0;
+
+            jointIndex_[joint->name] = chain_.size();
+            linkIndex_[joint->child_link_name] = links.size();
+            links.push_back(joint->child_link_name);
+            chain_.push_back(chainJoint);
+        }
+    }
+
+    // Mimic joints are resolved once all joints are known
+    for (std::map<std::string, int>::iterator it = jointIndex_.begin(); it != jointIndex_.end(); ++it) {
+        auto joint = model.getJoint(it->first);
+        if (joint->mimic) {
+            std::map<std::string, int>::iterator itMimic = jointIndex_.find(joint->mimic->joint_name);
+            if (itMimic != jointIndex_.end()) {
+                chain_[it->second].mimic = itMimic->second;
+                chain_[it->second].multiplier = joint->mimic->multiplier;
+                chain_[it->second].offset = joint->mimic->offset;
+            }
+        }
+    }
+
+    positions_.assign(chain_.size(), 0.0);
+    links_.assign(links.size(), tf::Transform::getIdentity());
+
+    loaded_ = true;
+    ROS_INFO("[PDG] Robot description loaded, %lu links", links.size());
+    return true;
+}
+
+int RobotKinematics::linkIndex(const std::string& link) const {
+    std::map<std::string, int>::const_iterator it = linkIndex_.find(link);
+    if (it == linkIndex_.end())
+        return -1;
+    return it->second;
+}
+
+void RobotKinematics::setJointPositions(const sensor_msgs::JointState& msg) {
+    if (msg.name != msgNames_) {
+        msgNames_ = msg.name;
+        msgIndex_.resize(msgNames_.size());
+        for (unsigned int i = 0; i < msgNames_.size(); i++) {
+            std::map<std::string, int>::iterator it = jointIndex_.find(msgNames_[i]);
+            msgIndex_[i] = it == jointIndex_.end() ? -1 : it->second;
+        }
+    }
+
+    for (unsigned int i = 0; i < msgIndex_.size() && i < msg.position.size(); i++) {
+        if (msgIndex_[i] >= 0)
+            positions_[msgIndex_[i]] = msg.position[i];
+    }
+}
+
+void RobotKinematics::update() {
+    for (unsigned int i = 0; i < chain_.size(); i++) {
+        const chainJoint_t& joint = chain_[i];
+
+        double position = positions_[i];
+        if (joint.mimic >= 0)
+            position = positions_[joint.mimic] * joint.multiplier + joint.offset;
+
+        tf::Transform motion = tf::Transform::getIdentity();
+        if (joint.type == REVOLUTE)
+            motion.setRotation(tf::Quaternion(joint.axis, position));
+        else if (joint.type == PRISMATIC)
+            motion.setOrigin(joint.axis * position);
+
+        links_[joint.child] = links_[joint.parent] * joint.origin * motion;
+    }
+}
@@ -0,0 +1,665 @@
+/*
+ * File:   SessionLog.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+#include "pdg/utility/SessionLog.h"
+
+#include "ros/ros.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace sessionLog {
+
+    static const char magic_[8] = {'T', 'O', 'A', 'S', 'T', 'L', 'O', 'G'};
+    static const uint32_t version_ = 2;
+
+    static size_t aligned(size_t size) {
+        return (size + 7) & ~((size_t) 7);
+    }
+
+    ////////////
+    // Writer //
+    ////////////
+
+    Writer::Writer() {
+        file_ = NULL;
+        offset_ = 0;
+        nbWrittenStrings_ = 0;
+    }
+
+    Writer::~Writer() {
+        close();
+    }
+
+    bool Writer::open(const std::string& path) {
+        close();
+        file_ = fopen(path.c_str(), "wb");
+        if (file_ == NULL) {
+            ROS_ERROR("[pdg_recorder] can't open %s", path.c_str());
+            return false;
+        }
+
+        // The offsets of the header are written by close
+        fileHeader_t header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, magic_, sizeof(magic_));
+        header.version = version_;
+        fwrite(&header, sizeof(header), 1, file_);
+        offset_ = sizeof(header);
+        index_.clear();
+        stringIds_.clear();
+        strings_.clear();
+        nbWrittenStrings_ = 0;
+        return true;
+    }
+
+    void Writer::close() {
+        if (file_ == NULL)
+            return;
+
+        fileHeader_t header;
+        memcpy(header.magic, magic_, sizeof(magic_));
+        header.version = version_;
+        header.nbFrames = index_.size();
+        header.stringsOffset = offset_;
+
+        frame_.clear();
+        strings(0);
+        fwrite(frame_.data(), 1, frame_.size(), file_);
+        header.indexOffset = offset_ + frame_.size();
+        frame_.clear();
+
+        if (!index_.empty())
+            fwrite(&index_[0], sizeof(frameIndex_t), index_.size(), file_);
+
+        fseek(file_, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, file_);
+        fclose(file_);
+        file_ = NULL;
+    }
+
+    void Writer::flush() {
+        if (file_ != NULL)
+            fflush(file_);
+    }
+
+    uint32_t Writer::stringIndex(const std::string& str) {
+        std::map<std::string, uint32_t>::iterator it = stringIds_.find(str);
+        if (it == stringIds_.end()) {
+            it = stringIds_.insert(std::make_pair(str, strings_.size())).first;
+            strings_.push_back(&it->first);
+        }
+        return it->second;
+    }
+
+    template <typename T>
+    void Writer::column(const std::vector<T>& values) {
+        size_t size = values.size() * sizeof(T);
+        size_t start = frame_.size();
+        frame_.resize(start + aligned(size), 0);
+        if (size > 0)
+            memcpy(&frame_[start], &values[0], size);
+    }
+
+    // strings from first: count, then length and characters of each string
+    void Writer::strings(unsigned int first) {
+        std::vector<uint32_t> count(1, strings_.size() - first);
+        column(count);
+        for (unsigned int i = first; i < strings_.size(); i++) {
+            std::vector<uint32_t> length(1, strings_[i]->size());
+            column(length);
+            column(std::vector<char>(strings_[i]->begin(), strings_[i]->end()));
+        }
+    }
+
+    void Writer::entities(const std::vector<const toaster_msgs::Entity*>& entities) {
+        std::vector<uint32_t> ids(entities.size()), names(entities.size());
+        std::vector<uint64_t> times(entities.size());
+        std::vector<double> poses(7 * entities.size());
+
+        for (unsigned int i = 0; i < entities.size(); i++) {
+            const toaster_msgs::Entity& entity = *entities[i];
+            ids[i] = stringIndex(entity.id);
+            names[i] = stringIndex(entity.name);
+            times[i] = entity.time;
+            poses[7 * i] = entity.pose.position.x;
+            poses[7 * i + 1] = entity.pose.position.y;
+            poses[7 * i + 2] = entity.pose.position.z;
+            poses[7 * i + 3] = entity.pose.orientation.x;
+            poses[7 * i + 4] = entity.pose.orientation.y;
+            poses[7 * i + 5] = entity.pose.orientation.z;
+            poses[7 * i + 6] = entity.pose.orientation.w;
+        }
+        column(ids);
+        column(names);
+        column(times);
+        column(poses);
+    }
+
+    void Writer::agents(const std::vector<const toaster_msgs::Agent*>& agents) {
+        std::vector<const toaster_msgs::Entity*> agentEntities, jointEntities;
+        std::vector<uint8_t> mobility;
+        std::vector<uint32_t> nbJoints, jointOwners, nbNames, names, nbBusyHands, busyHands, nbHasObjects, hasObjects;
+        std::vector<double> jointPositions;
+
+        for (unsigned int i = 0; i < agents.size(); i++) {
+            const toaster_msgs::Agent& agent = *agents[i];
+            agentEntities.push_back(&agent.meEntity);
+            mobility.push_back(agent.mobility);
+
+            nbJoints.push_back(agent.skeletonJoint.size());
+            for (unsigned int j = 0; j < agent.skeletonJoint.size(); j++) {
+                jointEntities.push_back(&agent.skeletonJoint[j].meEntity);
+                jointOwners.push_back(stringIndex(agent.skeletonJoint[j].jointOwner));
+                jointPositions.push_back(agent.skeletonJoint[j].position);
+            }
+
+            nbNames.push_back(agent.skeletonNames.size());
+            for (unsigned int j = 0; j < agent.skeletonNames.size(); j++)
+                names.push_back(stringIndex(agent.skeletonNames[j]));
+
+            nbBusyHands.push_back(agent.busyHands.size());
+            for (unsigned int j = 0; j < agent.busyHands.size(); j++)
+                busyHands.push_back(stringIndex(agent.busyHands[j]));
+
+            nbHasObjects.push_back(agent.hasObjects.size());
+            for (unsigned int j = 0; j < agent.hasObjects.size(); j++)
+                hasObjects.push_back(stringIndex(agent.hasObjects[j]));
+        }
+
+        entities(agentEntities);
+        column(mobility);
+
+        // Joints of all agents, the counts give their owner
+        column(nbJoints);
+        entities(jointEntities);
+        column(jointOwners);
+        column(jointPositions);
+
+        column(nbNames);
+        column(names);
+        column(nbBusyHands);
+        column(busyHands);
+        column(nbHasObjects);
+        column(hasObjects);
+    }
+
+    void Writer::writeFrame(uint32_t stream, const std_msgs::Header& header, uint32_t count) {
+        frameIndex_t index;
+        index.stamp = header.stamp.toNSec();
+        index.size = frame_.size();
+        index.seq = header.seq;
+        index.frameId = stringIndex(header.frame_id);
+        index.count = count;
+        index.stream = stream;
+
+        // The record starts with the strings new to this frame
+        record_.swap(frame_);
+        frame_.clear();
+        strings(nbWrittenStrings_);
+        nbWrittenStrings_ = strings_.size();
+        index.offset = offset_ + frame_.size() + sizeof(frameIndex_t);
+        column(std::vector<frameIndex_t>(1, index));
+        index_.push_back(index);
+
+        fwrite(frame_.data(), 1, frame_.size(), file_);
+        fwrite(record_.data(), 1, record_.size(), file_);
+        offset_ = index.offset + index.size;
+        frame_.clear();
+    }
+
+    void Writer::write(const toaster_msgs::HumanListStamped& msg) {
+        if (file_ == NULL)
+            return;
+
+        std::vector<uint32_t> ages;
+        std::vector<const toaster_msgs::Agent*> humans;
+        for (unsigned int i = 0; i < msg.humanList.size(); i++) {
+            ages.push_back(msg.humanList[i].age);
+            humans.push_back(&msg.humanList[i].meAgent);
+        }
+        column(ages);
+        agents(humans);
+        writeFrame(HUMANS, msg.header, humans.size());
+    }
+
+    void Writer::write(const toaster_msgs::RobotListStamped& msg) {
+        if (file_ == NULL)
+            return;
+
+        std::vector<uint32_t> maxSpeeds;
+        std::vector<const toaster_msgs::Agent*> robots;
+        for (unsigned int i = 0; i < msg.robotList.size(); i++) {
+            maxSpeeds.push_back(msg.robotList[i].maxSpeed);
+            robots.push_back(&msg.robotList[i].meAgent);
+        }
+        column(maxSpeeds);
+        agents(robots);
+        writeFrame(ROBOTS, msg.header, robots.size());
+    }
+
+    void Writer::write(const toaster_msgs::ObjectListStamped& msg) {
+        if (file_ == NULL)
+            return;
+
+        std::vector<const toaster_msgs::Entity*> objects;
+        std::vector<uint32_t> values;
+        for (unsigned int i = 0; i < msg.objectList.size(); i++) {
+            objects.push_back(&msg.objectList[i].meEntity);
+            values.push_back(stringIndex(msg.objectList[i].value));
+        }
+        entities(objects);
+        column(values);
+        writeFrame(OBJECTS, msg.header, objects.size());
+    }
+
+    void Writer::write(const toaster_msgs::FactList& msg, uint64_t stamp) {
+        if (file_ == NULL)
+            return;
+
+        unsigned int nbFacts = msg.factList.size();
+        std::vector<uint32_t> strings(8 * nbFacts);
+        std::vector<uint8_t> valueTypes(nbFacts);
+        std::vector<double> values(3 * nbFacts);
+        std::vector<uint64_t> times(3 * nbFacts);
+
+        for (unsigned int i = 0; i < nbFacts; i++) {
+            const toaster_msgs::Fact& fact = msg.factList[i];
+            strings[i] = stringIndex(fact.property);
+            strings[nbFacts + i] = stringIndex(fact.propertyType);
+            strings[2 * nbFacts + i] = stringIndex(fact.subProperty);
+            strings[3 * nbFacts + i] = stringIndex(fact.subjectId);
+            strings[4 * nbFacts + i] = stringIndex(fact.targetId);
+            strings[5 * nbFacts + i] = stringIndex(fact.subjectOwnerId);
+            strings[6 * nbFacts + i] = stringIndex(fact.targetOwnerId);
+            strings[7 * nbFacts + i] = stringIndex(fact.stringValue);
+            valueTypes[i] = fact.valueType;
+            values[i] = fact.factObservability;
+            values[nbFacts + i] = fact.doubleValue;
+            values[2 * nbFacts + i] = fact.confidence;
+            times[i] = fact.time;
+            times[nbFacts + i] = fact.timeStart;
+            times[2 * nbFacts + i] = fact.timeEnd;
+        }
+        column(strings);
+        column(valueTypes);
+        column(values);
+        column(times);
+
+        std_msgs::Header header;
+        header.stamp.fromNSec(stamp);
+        writeFrame(FACTS, header, nbFacts);
+    }
+
+    ////////////
+    // Reader //
+    ////////////
+
+    template <typename T>
+    const T* Reader::cursor_t::column(uint64_t size) {
+        if (ptr == NULL || size > (uint64_t) (end - ptr) / sizeof(T)) {
+            ptr = NULL;
+            return NULL;
+        }
+        const T* values = reinterpret_cast<const T*> (ptr);
+        // The padding of the last column of a truncated log may be missing
+        size_t length = aligned(size * sizeof(T));
+        ptr = length < (size_t) (end - ptr) ? ptr + length : end;
+        return values;
+    }
+
+    Reader::Reader() {
+        data_ = NULL;
+        size_ = 0;
+        nbFrames_ = 0;
+        index_ = NULL;
+    }
+
+    Reader::~Reader() {
+        close();
+    }
+
+    bool Reader::open(const std::string& path) {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(fileHeader_t)) {
+            ROS_ERROR("[pdg_replayer] can't read %s", path.c_str());
+            if (fd >= 0)
+                ::close(fd);
+            return false;
+        }
+
+        void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            ROS_ERROR("[pdg_replayer] can't map %s", path.c_str());
+            return false;
+        }
+        data_ = static_cast<const char*> (data);
+        size_ = st.st_size;
+
+        const fileHeader_t* header = reinterpret_cast<const fileHeader_t*> (data_);
+        if (memcmp(header->magic, magic_, sizeof(magic_)) != 0 || header->version != version_) {
+            ROS_ERROR("[pdg_replayer] %s is not a session log", path.c_str());
+            close();
+            return false;
+        }
+
+        if (!readIndex(*header)) {
+            ROS_WARN("[pdg_replayer] %s was not closed, reading its records", path.c_str());
+            scan();
+            ROS_WARN("[pdg_replayer] %u frames recovered", nbFrames_);
+        }
+        return true;
+    }
+
+    void Reader::close() {
+        if (data_ != NULL)
+            munmap(const_cast<char*> (data_), size_);
+        data_ = NULL;
+        size_ = 0;
+        nbFrames_ = 0;
+        index_ = NULL;
+        scannedIndex_.clear();
+        strings_.clear();
+    }
+
+    // Appends a list of strings to the table
+    bool Reader::readStrings(cursor_t& cursor) {
+        const uint32_t* count = cursor.column<uint32_t>(1);
+        if (count == NULL)
+            return false;
+
+        size_t first = strings_.size();
+        for (unsigned int i = 0; i < *count; i++) {
+            const uint32_t* length = cursor.column<uint32_t>(1);
+            const char* str = length == NULL ? NULL : cursor.column<char>(*length);
+            if (str == NULL) {
+                strings_.resize(first);
+                return false;
+            }
+            strings_.push_back(std::string(str, *length));
+        }
+        return true;
+    }
+
+    // Reads the table and the index written when the log was closed
+    bool Reader::readIndex(const fileHeader_t& header) {
+        if (header.indexOffset == 0 || header.stringsOffset < sizeof(fileHeader_t)
+                || header.stringsOffset > header.indexOffset || header.indexOffset > size_
+                || header.indexOffset % 8 != 0
+                || header.nbFrames > (size_ - header.indexOffset) / sizeof(frameIndex_t))
+            return false;
+
+        cursor_t cursor;
+        cursor.ptr = data_ + header.stringsOffset;
+        cursor.end = data_ + header.indexOffset;
+        if (!readStrings(cursor)) {
+            strings_.clear();
+            return false;
+        }
+
+        index_ = reinterpret_cast<const frameIndex_t*> (data_ + header.indexOffset);
+        for (unsigned int i = 0; i < header.nbFrames; i++) {
+            if (!validFrame(index_[i], header.stringsOffset)) {
+                index_ = NULL;
+                strings_.clear();
+                return false;
+            }
+        }
+        nbFrames_ = header.nbFrames;
+        return true;
+    }
+
+    // Reads the records up to the first incomplete one
+    void Reader::scan() {
+        cursor_t cursor;
+        cursor.ptr = data_ + sizeof(fileHeader_t);
+        cursor.end = data_ + size_;
+        while (cursor.ptr < cursor.end) {
+            size_t nbStrings = strings_.size();
+            if (!readStrings(cursor))
+                break;
+
+            const frameIndex_t* frame = cursor.column<frameIndex_t>(1);
+            if (frame == NULL || frame->offset != (uint64_t) (cursor.ptr - data_) || !validFrame(*frame, size_)) {
+                strings_.resize(nbStrings);
+                break;
+            }
+            scannedIndex_.push_back(*frame);
+            cursor.ptr = data_ + frame->offset + frame->size;
+        }
+
+        index_ = scannedIndex_.empty() ? NULL : &scannedIndex_[0];
+        nbFrames_ = scannedIndex_.size();
+    }
+
+    // Frames have to be before end, their columns are checked when read
+    bool Reader::validFrame(const frameIndex_t& frame, uint64_t end) const {
+        return frame.offset >= sizeof(fileHeader_t) && frame.offset % 8 == 0 && frame.offset <= end
+                && frame.size <= end - frame.offset && frame.frameId < strings_.size()
+                && frame.stream <= FACTS;
+    }
+
+    bool Reader::validIds(const uint32_t* ids, uint64_t size) const {
+        if (ids == NULL)
+            return false;
+        for (uint64_t i = 0; i < size; i++)
+            if (ids[i] >= strings_.size())
+                return false;
+        return true;
+    }
+
+    void Reader::header(unsigned int i, std_msgs::Header& header) const {
+        header.stamp.fromNSec(index_[i].stamp);
+        header.seq = index_[i].seq;
+        header.frame_id = strings_[index_[i].frameId];
+    }
+
+    Reader::cursor_t Reader::frameCursor(unsigned int i) const {
+        cursor_t cursor;
+        cursor.ptr = data_ + index_[i].offset;
+        cursor.end = cursor.ptr + index_[i].size;
+        return cursor;
+    }
+
+    bool Reader::entities(cursor_t& cursor, std::vector<toaster_msgs::Entity*>& entities) const {
+        uint64_t count = entities.size();
+        const uint32_t* ids = cursor.column<uint32_t>(count);
+        const uint32_t* names = cursor.column<uint32_t>(count);
+        const uint64_t* times = cursor.column<uint64_t>(count);
+        const double* poses = cursor.column<double>(7 * count);
+        if (poses == NULL || !validIds(ids, count) || !validIds(names, count))
+            return false;
+
+        for (unsigned int i = 0; i < count; i++) {
+            toaster_msgs::Entity& entity = *entities[i];
+            entity.id = strings_[ids[i]];
+            entity.name = strings_[names[i]];
+            entity.time = times[i];
+            entity.pose.position.x = poses[7 * i];
+            entity.pose.position.y = poses[7 * i + 1];
+            entity.pose.position.z = poses[7 * i + 2];
+            entity.pose.orientation.x = poses[7 * i + 3];
+            entity.pose.orientation.y = poses[7 * i + 4];
+            entity.pose.orientation.z = poses[7 * i + 5];
+            entity.pose.orientation.w = poses[7 * i + 6];
+            entity.inArea.clear();
+        }
+        return true;
+    }
+
+    bool Reader::agents(cursor_t& cursor, std::vector<toaster_msgs::Agent*>& agents) const {
+        uint32_t count = agents.size();
+
+        std::vector<toaster_msgs::Entity*> agentEntities(count);
+        for (unsigned int i = 0; i < count; i++)
+            agentEntities[i] = &agents[i]->meEntity;
+        if (!entities(cursor, agentEntities))
+            return false;
+
+        const uint8_t* mobility = cursor.column<uint8_t>(count);
+        const uint32_t* nbJoints = cursor.column<uint32_t>(count);
+        if (nbJoints == NULL)
+            return false;
+        for (unsigned int i = 0; i < count; i++)
+            agents[i]->mobility = mobility[i];
+
+        // Each joint takes at least an id, before the joints are allocated
+        uint64_t totalJoints = 0;
+        for (unsigned int i = 0; i < count; i++)
+            totalJoints += nbJoints[i];
+        if (totalJoints > (uint64_t) (cursor.end - cursor.ptr) / sizeof(uint32_t))
+            return false;
+
+        std::vector<toaster_msgs::Entity*> jointEntities;
+        for (unsigned int i = 0; i < count; i++) {
+            agents[i]->skeletonJoint.resize(nbJoints[i]);
+            for (unsigned int j = 0; j < nbJoints[i]; j++)
+                jointEntities.push_back(&agents[i]->skeletonJoint[j].meEntity);
+        }
+        if (!entities(cursor, jointEntities))
+            return false;
+
+        const uint32_t* jointOwners = cursor.column<uint32_t>(totalJoints);
+        const double* jointPositions = cursor.column<double>(totalJoints);
+        if (jointPositions == NULL || !validIds(jointOwners, totalJoints))
+            return false;
+        unsigned int joint = 0;
+        for (unsigned int i = 0; i < count; i++) {
+            for (unsigned int j = 0; j < nbJoints[i]; j++, joint++) {
+                agents[i]->skeletonJoint[j].jointOwner = strings_[jointOwners[joint]];
+                agents[i]->skeletonJoint[j].position = jointPositions[joint];
+            }
+        }
+
+        // skeletonNames, busyHands and hasObjects
+        std::vector<std::string> toaster_msgs::Agent::* lists[3] = {&toaster_msgs::Agent::skeletonNames,
+            &toaster_msgs::Agent::busyHands, &toaster_msgs::Agent::hasObjects};
+        for (unsigned int l = 0; l < 3; l++) {
+            const uint32_t* sizes = cursor.column<uint32_t>(count);
+            if (sizes == NULL)
+                return false;
+            uint64_t total = 0;
+            for (unsigned int i = 0; i < count; i++)
+                total += sizes[i];
+
+            const uint32_t* values = cursor.column<uint32_t>(total);
+            if (!validIds(values, total))
+                return false;
+            for (unsigned int i = 0; i < count; i++) {
+                std::vector<std::string>& list = agents[i]->*lists[l];
+                list.resize(sizes[i]);
+                for (unsigned int j = 0; j < sizes[i]; j++)
+                    list[j] = strings_[*values++];
+            }
+        }
+        return true;
+    }
+
+    // Each entity or fact takes at least a uint32_t column, which is checked
+    // before the message is allocated
+
+    bool Reader::read(unsigned int i, toaster_msgs::HumanListStamped& msg) const {
+        uint32_t count = index_[i].count;
+        if (index_[i].stream != HUMANS || count > index_[i].size / sizeof(uint32_t))
+            return false;
+        header(i, msg.header);
+        msg.humanList.resize(count);
+
+        cursor_t cursor = frameCursor(i);
+        const uint32_t* ages = cursor.column<uint32_t>(count);
+        if (ages == NULL)
+            return false;
+        std::vector<toaster_msgs::Agent*> humans(count);
+        for (unsigned int j = 0; j < count; j++) {
+            msg.humanList[j].age = ages[j];
+            humans[j] = &msg.humanList[j].meAgent;
+        }
+        return agents(cursor, humans);
+    }
+
+    bool Reader::read(unsigned int i, toaster_msgs::RobotListStamped& msg) const {
+        uint32_t count = index_[i].count;
+        if (index_[i].stream != ROBOTS || count > index_[i].size / sizeof(uint32_t))
+            return false;
+        header(i, msg.header);
+        msg.robotList.resize(count);
+
+        cursor_t cursor = frameCursor(i);
+        const uint32_t* maxSpeeds = cursor.column<uint32_t>(count);
+        if (maxSpeeds == NULL)
+            return false;
+        std::vector<toaster_msgs::Agent*> robots(count);
+        for (unsigned int j = 0; j < count; j++) {
+            msg.robotList[j].maxSpeed = maxSpeeds[j];
+            robots[j] = &msg.robotList[j].meAgent;
+        }
+        return agents(cursor, robots);
+    }
+
+    bool Reader::read(unsigned int i, toaster_msgs::ObjectListStamped& msg) const {
+        uint32_t count = index_[i].count;
+        if (index_[i].stream != OBJECTS || count > index_[i].size / sizeof(uint32_t))
+            return false;
+        header(i, msg.header);
+        msg.objectList.resize(count);
+
+        cursor_t cursor = frameCursor(i);
+        std::vector<toaster_msgs::Entity*> objects(count);
+        for (unsigned int j = 0; j < count; j++)
+            objects[j] = &msg.objectList[j].meEntity;
+        if (!entities(cursor, objects))
+            return false;
+
+        const uint32_t* values = cursor.column<uint32_t>(count);
+        if (!validIds(values, count))
+            return false;
+        for (unsigned int j = 0; j < count; j++)
+            msg.objectList[j].value = strings_[values[j]];
+        return true;
+    }
+
+    bool Reader::read(unsigned int i, toaster_msgs::FactList& msg) const {
+        uint32_t count = index_[i].count;
+        if (index_[i].stream != FACTS || count > index_[i].size / sizeof(uint32_t))
+            return false;
+
+        cursor_t cursor = frameCursor(i);
+        const uint32_t* strings = cursor.column<uint32_t>(8 * (uint64_t) count);
+        const uint8_t* valueTypes = cursor.column<uint8_t>(count);
+        const double* values = cursor.column<double>(3 * (uint64_t) count);
+        const uint64_t* times = cursor.column<uint64_t>(3 * (uint64_t) count);
+        if (times == NULL || !validIds(strings, 8 * (uint64_t) count))
+            return false;
+        msg.factList.resize(count);
+
+        for (unsigned int j = 0; j < count; j++) {
+            toaster_msgs::Fact& fact = msg.factList[j];
+            fact.property = strings_[strings[j]];
+            fact.propertyType = strings_[strings[count + j]];
+            fact.subProperty = strings_[strings[2 * count + j]];
+            fact.subjectId = strings_[strings[3 * count + j]];
+            fact.targetId = strings_[strings[4 * count + j]];
+            fact.subjectOwnerId = strings_[strings[5 * count + j]];
+            fact.targetOwnerId = strings_[strings[6 * count + j]];
+            fact.stringValue = strings_[strings[7 * count + j]];
+            fact.valueType = valueTypes[j];
+            fact.factObservability = values[j];
+            fact.doubleValue = values[count + j];
+            fact.confidence = values[2 * count + j];
+            fact.time = times[j];
+            fact.timeStart = times[count + j];
+            fact.timeEnd = times[2 * count + j];
+        }
+        return true;
+    }
+}
@@ -6,108 +6,169 @@
 #include <tinyxml.h>
 #include "ros/package.h"
 
+#include <boost/shared_ptr.hpp>
+#include <map>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
 using namespace std;
 
-vector<string> loadPropertiesFromXml(string objectID) {
-    vector<string> ret;
+// iot_objects.xml is parsed once, then again only when inotify reports a change.
+// A reload builds a new configuration and swaps it, so a lookup always sees a
+// complete configuration.
+
+struct iotValue_t {
+    string objectValueName;
+    string operation;
+    string objectValue;
+    string factValue;
+};
+
+struct iotFact_t {
+    string name;
+    vector<iotValue_t> values;
+};
 
-    std::stringstream pathIoTObj;
-    TiXmlDocument listIoTObj;
-    pathIoTObj << ros::package::getPath("pdg") << "/params/iot_objects.xml";
-    listIoTObj = TiXmlDocument(pathIoTObj.str());
+// objectID -> facts, in the file order
+typedef map<string, vector<iotFact_t> > iotObjects_t;
+
+static std::mutex iotMutex_;
+static boost::shared_ptr<const iotObjects_t> iotObjects_;
+static string iotDir_;
+static int iotNotify_ = -1;
+
+static boost::shared_ptr<const iotObjects_t> parseIoTObjects(const string& path) {
+    TiXmlDocument listIoTObj(path);
 
     if (!listIoTObj.LoadFile()) {
         ROS_WARN_ONCE("Error while loading xml file");
         ROS_WARN_ONCE("error #%d: %s", listIoTObj.ErrorId(), listIoTObj.ErrorDesc());
+        return boost::shared_ptr<const iotObjects_t>();
     }
 
+    boost::shared_ptr<iotObjects_t> objects(new iotObjects_t);
+
     TiXmlHandle hdl(&listIoTObj);
     TiXmlElement *object_elem = hdl.FirstChild("objects").FirstChild("object").Element();
 
-    std::string id;
     while (object_elem) { //for each element object
-        id = object_elem->Attribute("id");
-        if (id == objectID) {
-            TiXmlHandle hdl(object_elem);
-            TiXmlElement *fact_elem = hdl.FirstChild("fact").Element();
-
-            string fact_name;
-
-            while (fact_elem) { // for each fact
-                fact_name = fact_elem->Attribute("name");
-                // we add the fact name to the returned vector
-                ret.push_back(fact_name);
-                fact_elem = fact_elem->NextSiblingElement();
+        vector<iotFact_t>& facts = (*objects)[object_elem->Attribute("id")];
+
+        TiXmlHandle hdl(object_elem);
+        TiXmlElement *fact_elem = hdl.FirstChild("fact").Element();
+
+        while (fact_elem) { // for each fact
+            iotFact_t fact;
+            fact.name = fact_elem->Attribute("name");
+
+            TiXmlHandle hdl(fact_elem);
+            TiXmlElement *value_elem = hdl.FirstChild("value").Element();
+
+            // a value without object_value or fact_value keeps the ones of the previous value
+            string object_value;
+            string fact_value;
+            while (value_elem) { // for each value
+                iotValue_t value;
+                value.objectValueName = value_elem->Attribute("object_value_name");
+                value.operation = value_elem->Attribute("operation");
+                if (value_elem->Attribute("object_value"))
+                    object_value = value_elem->Attribute("object_value");
+                if (value_elem->Attribute("fact_value"))
+                    fact_value = value_elem->Attribute("fact_value");
+                value.objectValue = object_value;
+                value.factValue = fact_value;
+                fact.values.push_back(value);
+
+                value_elem = value_elem->NextSiblingElement();
             }
+            facts.push_back(fact);
+
+            fact_elem = fact_elem->NextSiblingElement();
         }
         object_elem = object_elem->NextSiblingElement();
     }
-    return ret;
+    return objects;
 }
 
-string loadValueFromXmlAsString(string objectID, string factName, string objectValueName, string objectValue) {
-    ROS_INFO("loadValueFromXmlAsString objectID:%s factName:%s objectValueName:%s objectValue:%s", objectID.c_str(), factName.c_str(), objectValueName.c_str(), objectValue.c_str());
-    std::string ret;
-
-    std::stringstream pathIoTObj;
-    TiXmlDocument listIoTObj;
-    pathIoTObj << ros::package::getPath("pdg") << "/params/iot_objects.xml";
-    listIoTObj = TiXmlDocument(pathIoTObj.str());
+// Gives the current configuration, loading it the first time and reloading it if the file changed
+static boost::shared_ptr<const iotObjects_t> getIoTObjects() {
+    std::lock_guard<std::mutex> lock(iotMutex_);
+
+    bool load = !iotObjects_;
+    if (load) {
+        iotDir_ = ros::package::getPath("pdg") + "/params";
+
+        // The directory is watched, as editors often replace the file
+        iotNotify_ = inotify_init1(IN_NONBLOCK);
+        if (iotNotify_ < 0 || inotify_add_watch(iotNotify_, iotDir_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0)
+            ROS_WARN("[PDG] iot_objects.xml will not be reloaded on changes");
+    } else if (iotNotify_ >= 0) {
+        char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        ssize_t length;
+        while ((length = read(iotNotify_, buffer, sizeof(buffer))) > 0) {
+            for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(struct inotify_event) + ((struct inotify_event*) ptr)->len) {
+                struct inotify_event* event = (struct inotify_event*) ptr;
+                if (event->len && string(event->name) == "iot_objects.xml")
+                    load = true;
+            }
+        }
+    }
 
-    if (!listIoTObj.LoadFile()) {
-        ROS_WARN_ONCE("Error while loading xml file");
-        ROS_WARN_ONCE("error #%d: %s", listIoTObj.ErrorId(), listIoTObj.ErrorDesc());
+    if (load) {
+        boost::shared_ptr<const iotObjects_t> objects = parseIoTObjects(iotDir_ + "/iot_objects.xml");
+        if (objects) {
+            if (iotObjects_)
+                ROS_INFO("[PDG] iot_objects.xml reloaded");
+            iotObjects_ = objects;
+        } else if (!iotObjects_)
+            iotObjects_.reset(new iotObjects_t);
     }
+    return iotObjects_;
+}
 
-    TiXmlHandle hdl(&listIoTObj);
-    TiXmlElement *object_elem = hdl.FirstChild("objects").FirstChild("object").Element();
+vector<string> loadPropertiesFromXml(string objectID) {
+    vector<string> ret;
 
-    std::string id;
+    boost::shared_ptr<const iotObjects_t> objects = getIoTObjects();
+    iotObjects_t::const_iterator it = objects->find(objectID);
+    if (it == objects->end())
+        return ret;
 
-    while (object_elem) { //for each element object
-        id = object_elem->Attribute("id");
-        if (id == objectID) {
-            TiXmlHandle hdl(object_elem);
-            TiXmlElement *fact_elem = hdl.FirstChild("fact").Element();
-
-            std::string fact_name;
-
-            while (fact_elem) { // for each fact
-                fact_name = fact_elem->Attribute("name");
-                if (fact_name == factName) {
-                    TiXmlHandle hdl(fact_elem);
-                    TiXmlElement *value_elem = hdl.FirstChild("value").Element();
-
-                    std::string object_value_name;
-                    std::string operation;
-                    std::string object_value;
-                    std::string fact_value;
-                    while (value_elem) { // for each value
-                        object_value_name = value_elem->Attribute("object_value_name");
-                        operation = value_elem->Attribute("operation");
-                        if (value_elem->Attribute("object_value")) {
-                            object_value = value_elem->Attribute("object_value");
-                        }
-                        if (value_elem->Attribute("fact_value")) {
-                            fact_value = value_elem->Attribute("fact_value");
-                        }
-                        if (objectValueName == object_value_name) {
-                            if (operation == "copy") {
-                                ret = objectValue;
-                            }
-                            else if (operation == "equals") {
-                                if (object_value == objectValue) {
-                                    ret = fact_value;
-                                }
-                            }
-                        }
-                        value_elem = value_elem->NextSiblingElement();
+    for (unsigned int i = 0; i < it->second.size(); i++)
+        ret.push_back(it->second[i].name);
+    return ret;
+}
+
+string loadValueFromXmlAsString(string objectID, string factName, string objectValueName, string objectValue) {
+    ROS_DEBUG("loadValueFromXmlAsString objectID:%s factName:%s objectValueName:%s objectValue:%s", objectID.c_str(), factName.c_str(), objectValueName.c_str(), objectValue.c_str());
+    std::string ret;
+
+    boost::shared_ptr<const iotObjects_t> objects = getIoTObjects();
+    iotObjects_t::const_iterator it = objects->find(objectID);
+    if (it == objects->end())
+        return ret;
+
+    // The last matching value gives the result
+    for (unsigned int i = 0; i < it->second.size(); i++) {
+        const iotFact_t& fact = it->second[i];
+        if (fact.name != factName)
+            continue;
+
+        for (unsigned int j = 0; j < fact.values.size(); j++) {
+            const iotValue_t& value = fact.values[j];
+            if (objectValueName == value.objectValueName) {
+                if (value.operation == "copy") {
+                    ret = objectValue;
+                }
+                else if (value.operation == "equals") {
+                    if (value.objectValue == objectValue) {
+                        ret = value.factValue;
                     }
                 }
-                fact_elem = fact_elem->NextSiblingElement();
             }
         }
-        object_elem = object_elem->NextSiblingElement();
     }
     return ret;
 }
@@ -0,0 +1,218 @@
+/*
+ * File:   test_om2m_payload.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+// Compares the reading of the OM2M payloads with the previous reading based
+// on getSubpart, which is kept here as the reference.
+
+#include "pdg/utility/OM2MPayload.h"
+
+#include <gtest/gtest.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string getSubpart(std::string data, std::string start, std::string stop) {
+  std::string part = "";
+  if(data.find(start) != std::string::npos) {
+    size_t start_pos = data.find(start);
+    size_t stop_pos = data.find(stop, start_pos);
+    part = data.substr(start_pos+start.length(), stop_pos-start_pos-start.length());
+  }
+  return part;
+}
+
+std::vector<struct preFact_t> referencePreFacts(const std::string& content)
+{
+  std::vector<struct preFact_t> preFacts;
+  size_t start_pos = 0;
+  while(content.find("\n", start_pos) != std::string::npos)
+  {
+    size_t stop_pos = content.find("\n", start_pos);
+    std::string data = content.substr(start_pos, stop_pos-start_pos);
+    if(data.find("=") != std::string::npos) // if valid data
+    {
+      size_t pos = data.find("=");
+      std::string name = data.substr(0, pos);
+      std::string type = getSubpart(data, "type=", " /");
+      std::string value = getSubpart(data, "data=", " /");
+      std::string unit = getSubpart(data, "unit=", " /");
+      std::string color = getSubpart(data, "color=", " /");
+
+      struct preFact_t preFact;
+      if(name != "DATA")
+        preFact.type = name;
+      else if(type != "")
+        preFact.type = type;
+      else
+        preFact.type = "";
+
+      if(value == "true")
+        preFact.data = "active";
+      else if(value == "false")
+        preFact.data = "inactive";
+      else
+        preFact.data = value;
+
+      if((unit != "") && (data != "true") && (data != "false"))
+        preFact.objectType = sensor;
+      else
+        preFact.objectType = other;
+
+      if((color != "") && (preFact.type.find("LAMP") != std::string::npos))
+        preFact.param = color;
+
+      if(preFact.type != "")
+        preFacts.push_back(preFact);
+    }
+
+    start_pos = stop_pos+1;
+  }
+  return preFacts;
+}
+
+void expectSamePreFacts(const std::string& content)
+{
+  std::vector<struct preFact_t> expected = referencePreFacts(content);
+  std::vector<struct preFact_t> preFacts;
+  readPreFacts(content, preFacts);
+
+  ASSERT_EQ(expected.size(), preFacts.size()) << "payload: \"" << content << "\"";
+  for (unsigned int i = 0; i < expected.size(); i++)
+  {
+    EXPECT_EQ(expected[i].type, preFacts[i].type) << "payload: \"" << content << "\"";
+    EXPECT_EQ(expected[i].data, preFacts[i].data) << "payload: \"" << content << "\"";
+    EXPECT_EQ(expected[i].param, preFacts[i].param) << "payload: \"" << content << "\"";
+    EXPECT_EQ(expected[i].objectType, preFacts[i].objectType) << "payload: \"" << content << "\"";
+  }
+}
+
+// Values as sent by the OM2M gateway
+const char* const recordedPayloads[] = {
+  "LAMP_KITCHEN=on type=LAMP /data=true /color=red\n",
+  "LAMP_KITCHEN=off type=LAMP /data=false /color=white\n",
+  "DATA=temperature type=TEMPERATURE /data=21.5 /unit=celsius\n",
+  "DATA=humidity type=HUMIDITY /data=43 /unit=percent\n",
+  "DOOR=closed type=DOOR /data=false\n",
+  "DATA=luminosity type=LUMINOSITY /data=310.25 /unit=lux\n"
+  "LAMP_LIVING=on type=LAMP /data=true /color=blue\n"
+  "PRESENCE=none type=PRESENCE /data=false\n",
+  "DATA=power type=POWER /data=1200 /unit=W\nDATA=energy type=ENERGY /data=3.2 /unit=kWh\n",
+  ""
+};
+const unsigned int nbRecordedPayloads = sizeof(recordedPayloads) / sizeof(recordedPayloads[0]);
+
+const char* const malformedPayloads[] = {
+  // no new line at the end
+  "LAMP_KITCHEN=on type=LAMP /data=true /color=red",
+  "DATA=temperature type=TEMPERATURE /data=21.5 /unit=celsius\nDATA=humidity type=HUMIDITY",
+  // no '='
+  "garbage\n",
+  "\n\n\n",
+  // empty name or type
+  "=x type=LAMP /data=true\n",
+  "DATA=x /data=3 /unit=C\n",
+  "DATA=x type= /data=3\n",
+  // missing or empty fields
+  "LAMP=on type=LAMP\n",
+  "LAMP=on type=LAMP /data= /color=\n",
+  "DATA=x type=T /data=\n",
+  // fields without separator, or repeated
+  "DATA=x type=T data=4 unit=C\n",
+  "DATA=x type=T /data=1 /data=2 /unit=C /unit=F\n",
+  "DATA=x type=T /data=1 /\n",
+  "DATA=x type=T /data=1 / /unit=C\n",
+  "DATA=x type=T /data=1  //unit=C\n",
+  // keys inside values
+  "DATA=x type=data=5 /unit=type= /data=7\n",
+  "DATA=type= /data=3\n",
+  "LAMP=color=red /data=true\n",
+  "DATA=x type=LAMP /color=red /color=blue /data=true\n",
+  // the whole line compared to true or false
+  "true\n",
+  "=true\n",
+  "a=b /unit=C /data=true\n",
+  // carriage returns
+  "DATA=x type=T /data=2 /unit=C\r\n",
+  "DATA=x\r type=T\r /data=2\r\n"
+};
+
+}
+
+TEST(OM2MPayload, recordedPayloads)
+{
+  for (unsigned int i = 0; i < nbRecordedPayloads; i++)
+    expectSamePreFacts(recordedPayloads[i]);
+}
+
+TEST(OM2MPayload, malformedPayloads)
+{
+  for (unsigned int i = 0; i < sizeof(malformedPayloads) / sizeof(malformedPayloads[0]); i++)
+    expectSamePreFacts(malformedPayloads[i]);
+}
+
+// Payloads made of random pieces of fields
+TEST(OM2MPayload, randomPayloads)
+{
+  const char* const pieces[] = {
+    "DATA", "LAMP", "x", "=", " ", "/", " /", "type=", "data=", "unit=", "color=",
+    "true", "false", "21.5", "red", "\n", "\r", "\n", "type=LAMP", " /data="
+  };
+  const unsigned int nbPieces = sizeof(pieces) / sizeof(pieces[0]);
+
+  srand(42);
+  for (unsigned int i = 0; i < 20000; i++)
+  {
+    std::string content;
+    unsigned int length = rand() % 16;
+    for (unsigned int j = 0; j < length; j++)
+      content += pieces[rand() % nbPieces];
+    expectSamePreFacts(content);
+    if (HasFailure())
+      return;
+  }
+}
+
+TEST(OM2MPayload, throughput)
+{
+  std::string content;
+  for (unsigned int i = 0; i < 100; i++)
+    content += recordedPayloads[i % nbRecordedPayloads];
+
+  const unsigned int nbReads = 500;
+  std::vector<struct preFact_t> preFacts;
+  size_t nbExpected = 0, nbRead = 0;
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  for (unsigned int i = 0; i < nbReads; i++)
+    nbExpected += referencePreFacts(content).size();
+  boost::posix_time::ptime middle = boost::posix_time::microsec_clock::universal_time();
+  for (unsigned int i = 0; i < nbReads; i++)
+  {
+    readPreFacts(content, preFacts);
+    nbRead += preFacts.size();
+  }
+  boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+
+  long referenceTime = (middle - start).total_microseconds();
+  long readTime = (stop - middle).total_microseconds();
+  RecordProperty("getSubpart_us", referenceTime);
+  RecordProperty("readPreFacts_us", readTime);
+  std::cout << "[PDG] " << content.size() * nbReads << " bytes read in " << readTime
+            << " us, " << referenceTime << " us with getSubpart" << std::endl;
+
+  EXPECT_EQ(nbExpected, nbRead);
+  EXPECT_LT(readTime, referenceTime);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,427 @@
+/*
+ * File:   test_session_log.cpp
+ *
+ * Created on October 19, 2026
+ */
+
+// Writes session logs and reads them back, complete, not closed, truncated
+// and corrupted.
+
+#include "pdg/utility/SessionLog.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace {
+
+std::string logPath(const std::string& name)
+{
+  return testing::TempDir() + "test_session_log_" + name + ".tlog";
+}
+
+std::string readFile(const std::string& path)
+{
+  std::ifstream file(path.c_str(), std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::string& content)
+{
+  std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+  file.write(content.data(), content.size());
+}
+
+std::string name(const std::string& prefix, unsigned int i)
+{
+  std::ostringstream str;
+  str << prefix << i;
+  return str.str();
+}
+
+void fillEntity(toaster_msgs::Entity& entity, const std::string& id, unsigned int i)
+{
+  entity.id = id;
+  entity.name = id + "_name";
+  entity.time = 1000 + i;
+  entity.pose.position.x = 0.5 * i;
+  entity.pose.position.y = -1.25 * i;
+  entity.pose.position.z = 0.1;
+  entity.pose.orientation.x = 0.0;
+  entity.pose.orientation.y = 0.0;
+  entity.pose.orientation.z = 0.6;
+  entity.pose.orientation.w = 0.8;
+}
+
+void fillAgent(toaster_msgs::Agent& agent, const std::string& id, unsigned int i)
+{
+  fillEntity(agent.meEntity, id, i);
+  agent.mobility = i % 2;
+  for (unsigned int j = 0; j < i; j++)
+  {
+    toaster_msgs::Joint joint;
+    fillEntity(joint.meEntity, name("joint", j), j);
+    joint.jointOwner = id;
+    joint.position = 0.2 * j;
+    agent.skeletonJoint.push_back(joint);
+    agent.skeletonNames.push_back(joint.meEntity.id);
+  }
+  if (i > 1)
+  {
+    agent.busyHands.push_back("rightHand");
+    agent.hasObjects.push_back(name("object", i));
+  }
+}
+
+toaster_msgs::HumanListStamped humanList(unsigned int frame)
+{
+  toaster_msgs::HumanListStamped msg;
+  msg.header.seq = frame;
+  msg.header.stamp.fromNSec(1000000000ULL + frame * 1000000ULL);
+  msg.header.frame_id = "map";
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    toaster_msgs::Human human;
+    human.age = 20 + i;
+    fillAgent(human.meAgent, name("human", i), i + frame);
+    msg.humanList.push_back(human);
+  }
+  return msg;
+}
+
+toaster_msgs::RobotListStamped robotList(unsigned int frame)
+{
+  toaster_msgs::RobotListStamped msg;
+  msg.header.seq = frame;
+  msg.header.stamp.fromNSec(1000000000ULL + frame * 1000000ULL);
+  msg.header.frame_id = "map";
+  toaster_msgs::Robot robot;
+  robot.maxSpeed = 2;
+  fillAgent(robot.meAgent, "pr2", 4);
+  msg.robotList.push_back(robot);
+  return msg;
+}
+
+toaster_msgs::ObjectListStamped objectList(unsigned int frame)
+{
+  toaster_msgs::ObjectListStamped msg;
+  msg.header.seq = frame;
+  msg.header.stamp.fromNSec(1000000000ULL + frame * 1000000ULL);
+  msg.header.frame_id = "map";
+  for (unsigned int i = 0; i < 4; i++)
+  {
+    toaster_msgs::Object object;
+    fillEntity(object.meEntity, name("object", i), i + frame);
+    object.value = i % 2 ? "full" : "";
+    msg.objectList.push_back(object);
+  }
+  return msg;
+}
+
+toaster_msgs::FactList factList(unsigned int frame)
+{
+  toaster_msgs::FactList msg;
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    toaster_msgs::Fact fact;
+    fact.property = "IsInHand";
+    fact.propertyType = "position";
+    fact.subProperty = "object";
+    fact.subjectId = name("object", i);
+    fact.targetId = "human0";
+    fact.subjectOwnerId = "";
+    fact.targetOwnerId = "";
+    fact.stringValue = "true";
+    fact.valueType = 0;
+    fact.factObservability = 0.5;
+    fact.doubleValue = 0.25 * frame;
+    fact.confidence = 1.0;
+    fact.time = frame;
+    fact.timeStart = frame - 1;
+    fact.timeEnd = frame + 1;
+    msg.factList.push_back(fact);
+  }
+  return msg;
+}
+
+uint64_t factStamp(unsigned int frame)
+{
+  return 1000000000ULL + frame * 1000000ULL + 500;
+}
+
+// Frames are written in turn for each stream
+void writeFrame(sessionLog::Writer& writer, unsigned int frame)
+{
+  switch (frame % 4)
+  {
+    case sessionLog::HUMANS: writer.write(humanList(frame)); break;
+    case sessionLog::ROBOTS: writer.write(robotList(frame)); break;
+    case sessionLog::OBJECTS: writer.write(objectList(frame)); break;
+    case sessionLog::FACTS: writer.write(factList(frame), factStamp(frame)); break;
+  }
+}
+
+void expectSameEntity(const toaster_msgs::Entity& expected, const toaster_msgs::Entity& entity)
+{
+  EXPECT_EQ(expected.id, entity.id);
+  EXPECT_EQ(expected.name, entity.name);
+  EXPECT_EQ(expected.time, entity.time);
+  EXPECT_EQ(expected.pose.position.x, entity.pose.position.x);
+  EXPECT_EQ(expected.pose.position.y, entity.pose.position.y);
+  EXPECT_EQ(expected.pose.position.z, entity.pose.position.z);
+  EXPECT_EQ(expected.pose.orientation.x, entity.pose.orientation.x);
+  EXPECT_EQ(expected.pose.orientation.y, entity.pose.orientation.y);
+  EXPECT_EQ(expected.pose.orientation.z, entity.pose.orientation.z);
+  EXPECT_EQ(expected.pose.orientation.w, entity.pose.orientation.w);
+}
+
+void expectSameAgent(const toaster_msgs::Agent& expected, const toaster_msgs::Agent& agent)
+{
+  expectSameEntity(expected.meEntity, agent.meEntity);
+  EXPECT_EQ(expected.mobility, agent.mobility);
+  ASSERT_EQ(expected.skeletonJoint.size(), agent.skeletonJoint.size());
+  for (unsigned int j = 0; j < expected.skeletonJoint.size(); j++)
+  {
+    expectSameEntity(expected.skeletonJoint[j].meEntity, agent.skeletonJoint[j].meEntity);
+    EXPECT_EQ(expected.skeletonJoint[j].jointOwner, agent.skeletonJoint[j].jointOwner);
+    EXPECT_EQ(expected.skeletonJoint[j].position, agent.skeletonJoint[j].position);
+  }
+  EXPECT_EQ(expected.skeletonNames, agent.skeletonNames);
+  EXPECT_EQ(expected.busyHands, agent.busyHands);
+  EXPECT_EQ(expected.hasObjects, agent.hasObjects);
+}
+
+void expectSameHeader(const std_msgs::Header& expected, const std_msgs::Header& header)
+{
+  EXPECT_EQ(expected.seq, header.seq);
+  EXPECT_EQ(expected.stamp.toNSec(), header.stamp.toNSec());
+  EXPECT_EQ(expected.frame_id, header.frame_id);
+}
+
+void expectFrame(const sessionLog::Reader& reader, unsigned int frame)
+{
+  ASSERT_EQ(frame % 4, reader.frame(frame).stream);
+  switch (frame % 4)
+  {
+    case sessionLog::HUMANS:
+    {
+      toaster_msgs::HumanListStamped expected = humanList(frame), msg;
+      ASSERT_TRUE(reader.read(frame, msg));
+      expectSameHeader(expected.header, msg.header);
+      ASSERT_EQ(expected.humanList.size(), msg.humanList.size());
+      for (unsigned int i = 0; i < expected.humanList.size(); i++)
+      {
+        EXPECT_EQ(expected.humanList[i].age, msg.humanList[i].age);
+        expectSameAgent(expected.humanList[i].meAgent, msg.humanList[i].meAgent);
+      }
+      break;
+    }
+    case sessionLog::ROBOTS:
+    {
+      toaster_msgs::RobotListStamped expected = robotList(frame), msg;
+      ASSERT_TRUE(reader.read(frame, msg));
+      expectSameHeader(expected.header, msg.header);
+      ASSERT_EQ(expected.robotList.size(), msg.robotList.size());
+      EXPECT_EQ(expected.robotList[0].maxSpeed, msg.robotList[0].maxSpeed);
+      expectSameAgent(expected.robotList[0].meAgent, msg.robotList[0].meAgent);
+      break;
+    }
+    case sessionLog::OBJECTS:
+    {
+      toaster_msgs::ObjectListStamped expected = objectList(frame), msg;
+      ASSERT_TRUE(reader.read(frame, msg));
+      expectSameHeader(expected.header, msg.header);
+      ASSERT_EQ(expected.objectList.size(), msg.objectList.size());
+      for (unsigned int i = 0; i < expected.objectList.size(); i++)
+      {
+        expectSameEntity(expected.objectList[i].meEntity, msg.objectList[i].meEntity);
+        EXPECT_EQ(expected.objectList[i].value, msg.objectList[i].value);
+      }
+      break;
+    }
+    case sessionLog::FACTS:
+    {
+      toaster_msgs::FactList expected = factList(frame), msg;
+      EXPECT_EQ(factStamp(frame), reader.frame(frame).stamp);
+      ASSERT_TRUE(reader.read(frame, msg));
+      ASSERT_EQ(expected.factList.size(), msg.factList.size());
+      for (unsigned int i = 0; i < expected.factList.size(); i++)
+      {
+        const toaster_msgs::Fact& fact = msg.factList[i];
+        EXPECT_EQ(expected.factList[i].property, fact.property);
+        EXPECT_EQ(expected.factList[i].propertyType, fact.propertyType);
+        EXPECT_EQ(expected.factList[i].subProperty, fact.subProperty);
+        EXPECT_EQ(expected.factList[i].subjectId, fact.subjectId);
+        EXPECT_EQ(expected.factList[i].targetId, fact.targetId);
+        EXPECT_EQ(expected.factList[i].subjectOwnerId, fact.subjectOwnerId);
+        EXPECT_EQ(expected.factList[i].targetOwnerId, fact.targetOwnerId);
+        EXPECT_EQ(expected.factList[i].stringValue, fact.stringValue);
+        EXPECT_EQ(expected.factList[i].valueType, fact.valueType);
+        EXPECT_EQ(expected.factList[i].factObservability, fact.factObservability);
+        EXPECT_EQ(expected.factList[i].doubleValue, fact.doubleValue);
+        EXPECT_EQ(expected.factList[i].confidence, fact.confidence);
+        EXPECT_EQ(expected.factList[i].time, fact.time);
+        EXPECT_EQ(expected.factList[i].timeStart, fact.timeStart);
+        EXPECT_EQ(expected.factList[i].timeEnd, fact.timeEnd);
+      }
+      break;
+    }
+  }
+}
+
+// Reads all the frames, which must not crash whatever the content
+unsigned int readAll(const sessionLog::Reader& reader)
+{
+  unsigned int nbRead = 0;
+  toaster_msgs::HumanListStamped human_msg;
+  toaster_msgs::RobotListStamped robot_msg;
+  toaster_msgs::ObjectListStamped object_msg;
+  toaster_msgs::FactList fact_msg;
+  for (unsigned int i = 0; i < reader.nbFrames(); i++)
+  {
+    bool read = false;
+    switch (reader.frame(i).stream)
+    {
+      case sessionLog::HUMANS: read = reader.read(i, human_msg); break;
+      case sessionLog::ROBOTS: read = reader.read(i, robot_msg); break;
+      case sessionLog::OBJECTS: read = reader.read(i, object_msg); break;
+      case sessionLog::FACTS: read = reader.read(i, fact_msg); break;
+    }
+    if (read)
+      nbRead++;
+  }
+  return nbRead;
+}
+
+const unsigned int nbFrames = 40;
+
+std::string completeLog()
+{
+  std::string path = logPath("complete");
+  sessionLog::Writer writer;
+  EXPECT_TRUE(writer.open(path));
+  for (unsigned int i = 0; i < nbFrames; i++)
+    writeFrame(writer, i);
+  writer.close();
+  return readFile(path);
+}
+
+}
+
+TEST(SessionLog, roundTrip)
+{
+  std::string path = logPath("round_trip");
+  sessionLog::Writer writer;
+  ASSERT_TRUE(writer.open(path));
+  for (unsigned int i = 0; i < nbFrames; i++)
+    writeFrame(writer, i);
+  EXPECT_EQ(nbFrames, writer.nbFrames());
+  writer.close();
+
+  sessionLog::Reader reader;
+  ASSERT_TRUE(reader.open(path));
+  ASSERT_EQ(nbFrames, reader.nbFrames());
+  for (unsigned int i = 0; i < nbFrames; i++)
+    expectFrame(reader, i);
+}
+
+TEST(SessionLog, wrongStream)
+{
+  std::string path = logPath("wrong_stream");
+  writeFile(path, completeLog());
+
+  sessionLog::Reader reader;
+  ASSERT_TRUE(reader.open(path));
+  toaster_msgs::FactList msg;
+  EXPECT_FALSE(reader.read(sessionLog::HUMANS, msg));
+}
+
+TEST(SessionLog, notClosed)
+{
+  std::string path = logPath("not_closed");
+  sessionLog::Writer writer;
+  ASSERT_TRUE(writer.open(path));
+  for (unsigned int i = 0; i < nbFrames; i++)
+    writeFrame(writer, i);
+  writer.flush();
+
+  // As left by a recorder which was killed
+  std::string copyPath = logPath("not_closed_copy");
+  writeFile(copyPath, readFile(path));
+  writer.close();
+
+  sessionLog::Reader reader;
+  ASSERT_TRUE(reader.open(copyPath));
+  ASSERT_EQ(nbFrames, reader.nbFrames());
+  for (unsigned int i = 0; i < nbFrames; i++)
+    expectFrame(reader, i);
+}
+
+TEST(SessionLog, truncated)
+{
+  std::string content = completeLog();
+  std::string path = logPath("truncated");
+
+  // Without the table and the index, only complete records are read
+  unsigned int lastNbFrames = 0;
+  for (size_t size = sizeof(sessionLog::fileHeader_t); size < content.size(); size += 7)
+  {
+    writeFile(path, content.substr(0, size));
+    sessionLog::Reader reader;
+    ASSERT_TRUE(reader.open(path));
+    ASSERT_LE(reader.nbFrames(), nbFrames);
+    ASSERT_GE(reader.nbFrames(), lastNbFrames);
+    lastNbFrames = reader.nbFrames();
+    for (unsigned int i = 0; i < reader.nbFrames(); i++)
+      expectFrame(reader, i);
+  }
+  EXPECT_EQ(nbFrames, lastNbFrames);
+
+  writeFile(path, content.substr(0, sizeof(sessionLog::fileHeader_t) - 1));
+  sessionLog::Reader reader;
+  EXPECT_FALSE(reader.open(path));
+}
+
+TEST(SessionLog, corrupted)
+{
+  std::string content = completeLog();
+  std::string path = logPath("corrupted");
+
+  srand(42);
+  for (unsigned int n = 0; n < 2000; n++)
+  {
+    std::string corrupted = content;
+    unsigned int nbChanges = 1 + rand() % 4;
+    for (unsigned int c = 0; c < nbChanges; c++)
+    {
+      size_t pos = 8 + rand() % (corrupted.size() - 8);
+      // The magic is kept. Sizes and ids are small numbers, make them large
+      corrupted[pos] = rand() % 2 ? (char) 0xff : (char) (rand() % 256);
+    }
+    writeFile(path, corrupted);
+
+    sessionLog::Reader reader;
+    if (reader.open(path))
+    {
+      EXPECT_LE(readAll(reader), reader.nbFrames());
+    }
+  }
+}
+
+TEST(SessionLog, notALog)
+{
+  std::string path = logPath("not_a_log");
+  writeFile(path, std::string(256, 'x'));
+  sessionLog::Reader reader;
+  EXPECT_FALSE(reader.open(path));
+  EXPECT_FALSE(reader.open(logPath("missing")));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,7 @@
 
 //Services
 #include <toaster_msgs/SetEntityPose.h>
+#include <toaster_msgs/SetEntitiesPose.h>
 #include <toaster_msgs/AddEntity.h>
 #include <toaster_msgs/RemoveEntity.h>
 #include <toaster_msgs/AddAgent.h>
@@ -286,6 +287,29 @@ bool setEntityPose(toaster_msgs::SetEntityPose::Request &req,
     return true;
 }
 
+bool setEntitiesPose(toaster_msgs::SetEntitiesPose::Request &req,
+        toaster_msgs::SetEntitiesPose::Response & res) {
+
+    if (req.ownerId.size() != req.id.size() || req.type.size() != req.id.size() || req.pose.size() != req.id.size()) {
+        ROS_WARN("[toaster_simu][Request] request to set entities pose with "
+                "arrays of different sizes, sending back response: false");
+        res.answer = false;
+        return true;
+    }
+
+    // Answer is false if one of the entities is unknown, the others are still set
+    res.answer = true;
+    for (unsigned int i = 0; i < req.id.size(); i++) {
+        if (!setEntityPose(req.id[i], req.type[i], req.ownerId[i], req.pose[i])) {
+            ROS_WARN("[toaster_simu][Request] request to set entity pose with "
+                    "id %s, we don't know this entity, please add it first", req.id[i].c_str());
+            res.answer = false;
+        }
+    }
+    ROS_DEBUG("[toaster_simu][Request] request to set %lu entities pose", req.id.size());
+    return true;
+}
+
 bool addEntity(toaster_msgs::AddEntity::Request &req,
         toaster_msgs::AddEntity::Response & res) {
 
@@ -528,6 +552,9 @@ int main(int argc, char** argv) {
     ros::ServiceServer setEntPose = node.advertiseService("toaster_simu/set_entity_pose", setEntityPose);
     ROS_INFO("Ready to set Entity position.");
 
+    ros::ServiceServer setEntsPose = node.advertiseService("toaster_simu/set_entities_pose", setEntitiesPose);
+    ROS_INFO("Ready to set Entities position.");
+
     ros::ServiceServer serviceAddEnt = node.advertiseService("toaster_simu/add_entity", addEntity);
     ROS_INFO("[Request] Ready to add entities.");
 
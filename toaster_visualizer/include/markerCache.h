@@ -0,0 +1,60 @@
+#include <map>
+#include <string>
+#include <utility>
+
+#include <visualization_msgs/MarkerArray.h>
+#include <visualization_msgs/Marker.h>
+
+#ifndef MARKERCACHE_H
+#define MARKERCACHE_H
+
+/**
+ * Markers last sent to rviz on one topic.
+ * Markers are sent without lifetime: a marker is sent again only when it changed,
+ * and deleted when it is not in the list anymore.
+ */
+class MarkerCache
+{
+public:
+  MarkerCache();
+
+  /**
+   * set the changes under which a marker is not sent again
+   * @param position 	distance in m on each axis, also used for the points of lines and arrows
+   * @param orientation 	difference of each quaternion component
+   * @param color 		difference of each color component
+   * @param scale 		difference of each dimension
+   */
+  void setThresholds(double position, double orientation, double color, double scale);
+
+  /**
+   * compute the markers to send so that rviz shows the list
+   * @param list 		markers to show
+   * @param changes 		filled with the new and changed markers, and the deletion of the removed ones
+   * @param refresh 		if true, all markers of the list are sent
+   * @return void
+   */
+  void update(const visualization_msgs::MarkerArray& list, visualization_msgs::MarkerArray& changes, bool refresh);
+
+private:
+  typedef std::pair<std::string, int> markerKey_t;
+
+  struct entry_t
+  {
+    visualization_msgs::Marker marker;
+    unsigned int update;
+  };
+
+  bool changed(const visualization_msgs::Marker& last, const visualization_msgs::Marker& current) const;
+  bool moved(const geometry_msgs::Point& last, const geometry_msgs::Point& current) const;
+
+  std::map<markerKey_t, entry_t> cache_;
+  unsigned int update_;
+
+  double positionThreshold_;
+  double orientationThreshold_;
+  double colorThreshold_;
+  double scaleThreshold_;
+};
+
+#endif /*MARKERCACHE_H*/
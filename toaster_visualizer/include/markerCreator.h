@@ -7,7 +7,7 @@
 #include <geometry_msgs/Polygon.h>
 #include <geometry_msgs/Quaternion.h>
 
-#include <tinyxml.h>
+#include <boost/unordered_map.hpp>
 
 #ifndef MARKERCREATOR_H
 #define MARKERCREATOR_H
@@ -15,6 +15,28 @@
 namespace MarkerCreator
 {
 
+  /**
+   * mesh of an entity, as given by the xml lists
+   */
+  struct meshAsset_t
+  {
+    std::string meshResource;
+    double scale;
+  };
+
+  /**
+   * meshes indexed by entity name
+   */
+  typedef boost::unordered_map<std::string, meshAsset_t> meshTable_t;
+
+  /**
+   * parse a mesh list (list_obj.xml, list_human.xml, ...) once into a table
+   * @param path 		path of the xml file
+   * @param table 		table filled with the meshes of the file, an optional scale attribute defaults to 1
+   * @return bool 		false if the file can't be loaded
+   */
+  bool loadMeshTable(const std::string& path, meshTable_t& table);
+
   /**
    * create a circle marker
    * @param p  		point from geometry library locating the center of the circle
@@ -47,9 +69,10 @@ namespace MarkerCreator
    * @param z 			coordinates of object's base in thx z direction
    * @param scale 		dimension of the marker
    * @param name 		marker's name
+   * @param listObj 	meshes of the objects
    * @return marker 	object marker or mesh marker if the object is in the mesh database
    */
-  visualization_msgs::Marker defineObj(geometry_msgs::Pose pose, std::string name, bool activated, int id, TiXmlDocument& listObj, double scale = 1);
+  visualization_msgs::Marker defineObj(geometry_msgs::Pose pose, std::string name, bool activated, int id, const meshTable_t& listObj, double scale = 1);
 
   /**
    * create a human marker
@@ -58,9 +81,10 @@ namespace MarkerCreator
    * @param z 			coordinates of human's base in the z direction
    * @param scale 		dimension of the marker
    * @param name 		marker's name
+   * @param listHuman 	meshes of the humans
    * @return marker 	mesh marker of human
    */
-  visualization_msgs::Marker defineHuman(geometry_msgs::Pose pose, double scale, std::string name, int id, TiXmlDocument& listHuman);
+  visualization_msgs::Marker defineHuman(geometry_msgs::Pose pose, double scale, std::string name, int id, const meshTable_t& listHuman);
 
   /**
    * create a robot marker
@@ -69,11 +93,12 @@ namespace MarkerCreator
    * @param z 			coordinates of robot's base in the z direction
    * @param scale 		dimension of the marker
    * @param name 		marker's name
+   * @param listRobot 	meshes of the robots
    * @return marker 	mesh marker of robot
    */
-  visualization_msgs::Marker defineRobot(geometry_msgs::Pose pose, double scale, std::string name, int id, TiXmlDocument& listRobot);
+  visualization_msgs::Marker defineRobot(geometry_msgs::Pose pose, double scale, std::string name, int id, const meshTable_t& listRobot);
 
-  visualization_msgs::Marker defineArrow(visualization_msgs::Marker& sub, visualization_msgs::Marker& targ, double confidence, bool distance, int id);
+  visualization_msgs::Marker defineArrow(const visualization_msgs::Marker& sub, const visualization_msgs::Marker& targ, double confidence, bool distance, int id);
 }
 
 #endif /*MARKERCREATOR_H*/
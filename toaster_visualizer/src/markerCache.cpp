@@ -0,0 +1,96 @@
+#include "markerCache.h"
+
+#include <cmath>
+
+MarkerCache::MarkerCache() {
+    update_ = 0;
+    positionThreshold_ = 0.001;
+    orientationThreshold_ = 0.001;
+    colorThreshold_ = 0.01;
+    scaleThreshold_ = 0.001;
+}
+
+void MarkerCache::setThresholds(double position, double orientation, double color, double scale) {
+    positionThreshold_ = position;
+    orientationThreshold_ = orientation;
+    colorThreshold_ = color;
+    scaleThreshold_ = scale;
+}
+
+bool MarkerCache::moved(const geometry_msgs::Point& last, const geometry_msgs::Point& current) const {
+    return fabs(last.x - current.x) > positionThreshold_
+            || fabs(last.y - current.y) > positionThreshold_
+            || fabs(last.z - current.z) > positionThreshold_;
+}
+
+bool MarkerCache::changed(const visualization_msgs::Marker& last, const visualization_msgs::Marker& current) const {
+    //what the marker is
+    if (last.type != current.type || last.mesh_resource != current.mesh_resource
+            || last.text != current.text || last.header.frame_id != current.header.frame_id
+            || last.points.size() != current.points.size())
+        return true;
+
+    //pose
+    if (moved(last.pose.position, current.pose.position)
+            || fabs(last.pose.orientation.x - current.pose.orientation.x) > orientationThreshold_
+            || fabs(last.pose.orientation.y - current.pose.orientation.y) > orientationThreshold_
+            || fabs(last.pose.orientation.z - current.pose.orientation.z) > orientationThreshold_
+            || fabs(last.pose.orientation.w - current.pose.orientation.w) > orientationThreshold_)
+        return true;
+
+    for (unsigned int i = 0; i < current.points.size(); i++)
+        if (moved(last.points[i], current.points[i]))
+            return true;
+
+    //color
+    if (fabs(last.color.r - current.color.r) > colorThreshold_
+            || fabs(last.color.g - current.color.g) > colorThreshold_
+            || fabs(last.color.b - current.color.b) > colorThreshold_
+            || fabs(last.color.a - current.color.a) > colorThreshold_)
+        return true;
+
+    //scale
+    return fabs(last.scale.x - current.scale.x) > scaleThreshold_
+            || fabs(last.scale.y - current.scale.y) > scaleThreshold_
+            || fabs(last.scale.z - current.scale.z) > scaleThreshold_;
+}
+
+void MarkerCache::update(const visualization_msgs::MarkerArray& list, visualization_msgs::MarkerArray& changes, bool refresh) {
+    update_++;
+    changes.markers.clear();
+
+    for (unsigned int i = 0; i < list.markers.size(); i++) {
+        const visualization_msgs::Marker& marker = list.markers[i];
+        markerKey_t key(marker.ns, marker.id);
+
+        std::map<markerKey_t, entry_t>::iterator it = cache_.find(key);
+        if (it == cache_.end()) {
+            entry_t entry;
+            entry.marker = marker;
+            it = cache_.insert(std::make_pair(key, entry)).first;
+            changes.markers.push_back(marker);
+        } else if (it->second.update == update_) {
+            //same marker twice in the list, the first one is shown
+            continue;
+        } else if (refresh || changed(it->second.marker, marker)) {
+            it->second.marker = marker;
+            changes.markers.push_back(marker);
+        }
+        it->second.update = update_;
+    }
+
+    //markers not in the list anymore
+    for (std::map<markerKey_t, entry_t>::iterator it = cache_.begin(); it != cache_.end();) {
+        if (it->second.update != update_) {
+            visualization_msgs::Marker marker;
+            marker.header.frame_id = it->second.marker.header.frame_id;
+            marker.ns = it->first.first;
+            marker.id = it->first.second;
+            marker.action = visualization_msgs::Marker::DELETE;
+            changes.markers.push_back(marker);
+
+            cache_.erase(it++);
+        } else
+            ++it;
+    }
+}
@@ -1,8 +1,43 @@
 #include "markerCreator.h"
 
+#include <tinyxml.h>
+#include <cstdlib>
+
 namespace MarkerCreator
 {
 
+bool loadMeshTable(const std::string& path, meshTable_t& table) {
+    TiXmlDocument doc(path);
+
+    if (!doc.LoadFile()) {
+        ROS_WARN_ONCE("Error while loading xml file");
+        ROS_WARN_ONCE("error # %d", doc.ErrorId());
+        ROS_WARN_ONCE("%s", doc.ErrorDesc());
+        return false;
+    }
+
+    TiXmlHandle hdl(&doc);
+    TiXmlElement *elem = hdl.FirstChildElement().FirstChildElement().Element();
+
+    while (elem) //for each element of the xml file
+    {
+        const char* name = elem->Attribute("name");
+        const char* mesh_r = elem->Attribute("mesh_resource");
+        const char* scale = elem->Attribute("scale");
+
+        if (name && mesh_r) {
+            meshAsset_t asset;
+            asset.meshResource = mesh_r;
+            asset.scale = scale ? atof(scale) : 1.0;
+
+            // as when the file was searched, the first element of a name is used
+            table.insert(std::make_pair(std::string(name), asset));
+        }
+        elem = elem->NextSiblingElement();
+    }
+    return true;
+}
+
 visualization_msgs::Marker defineCircle(geometry_msgs::Point p, double rayon, double height, std::string name, int id) {
    //declaration
    visualization_msgs::Marker marker;
@@ -130,7 +165,7 @@ for (int i = 0; i < poly.points.size(); i++) {
     return markersarray;
 }
 
-visualization_msgs::Marker defineObj(geometry_msgs::Pose pose, std::string name, bool activated, int id, TiXmlDocument& listObj, double scale){
+visualization_msgs::Marker defineObj(geometry_msgs::Pose pose, std::string name, bool activated, int id, const meshTable_t& listObj, double scale){
     //declaration
     double roll, pitch, yaw;
     visualization_msgs::Marker marker;
@@ -177,48 +212,34 @@ visualization_msgs::Marker defineObj(geometry_msgs::Pose pose, std::string name,
     //type
     marker.type = visualization_msgs::Marker::CUBE; //marker by default
 
-    TiXmlHandle hdl(&listObj);
-    TiXmlElement *elem = hdl.FirstChildElement().FirstChildElement().Element();
-
-    std::string name_obj;
-    std::string mesh_r;
-
-    while (elem) //for each element of the xml file
+    meshTable_t::const_iterator it = listObj.find(name);
+    if (it != listObj.end()) //if there is a 3d model relativ to this object
     {
-        name_obj = elem->Attribute("name");
-        mesh_r = elem->Attribute("mesh_resource");
-        elem = elem->NextSiblingElement();
+        marker.scale.x = scale * it->second.scale;
+        marker.scale.y = scale * it->second.scale;
+        marker.scale.z = scale * it->second.scale;
 
-        if (name_obj.compare(name) == 0) //if there is a 3d model relativ to this object
+        marker.type = visualization_msgs::Marker::MESH_RESOURCE; //use it as mesh
+        marker.mesh_resource = it->second.meshResource;
+        marker.mesh_use_embedded_materials = true;
+
+        if(activated)
         {
-            marker.scale.x = scale;
-            marker.scale.y = scale;
-            marker.scale.z = scale;
-
-            marker.type = visualization_msgs::Marker::MESH_RESOURCE; //use it as mesh
-            marker.mesh_resource = mesh_r;
-            marker.mesh_use_embedded_materials = true;
-
-            if(activated)
-            {
-              marker.color.r = 0.75;
-              marker.color.g = 0.5;
-              marker.color.b = 0.25;
-              marker.color.a = 0.9;
-            }
-            else
-            {
-              marker.color.r = 0.25;
-              marker.color.g = 0.5;
-              marker.color.b = 0.75;
-              marker.color.a = 0.0;
-            }
-
-            elem = NULL;
+          marker.color.r = 0.75;
+          marker.color.g = 0.5;
+          marker.color.b = 0.25;
+          marker.color.a = 0.9;
+        }
+        else
+        {
+          marker.color.r = 0.25;
+          marker.color.g = 0.5;
+          marker.color.b = 0.75;
+          marker.color.a = 0.0;
         }
     }
 
-    marker.lifetime = ros::Duration(1.0);
+    marker.lifetime = ros::Duration();
 
     return marker;
 }
@@ -257,7 +278,7 @@ visualization_msgs::Marker defineName(visualization_msgs::Marker marker) {
 
 }
 
-visualization_msgs::Marker defineHuman(geometry_msgs::Pose pose, double scale, std::string name, int id, TiXmlDocument& listHuman) {
+visualization_msgs::Marker defineHuman(geometry_msgs::Pose pose, double scale, std::string name, int id, const meshTable_t& listHuman) {
 
     //declaration
     double roll, pitch, yaw;
@@ -300,41 +321,30 @@ visualization_msgs::Marker defineHuman(geometry_msgs::Pose pose, double scale, s
     //type of marker
     marker.type = visualization_msgs::Marker::MESH_RESOURCE;
 
-    TiXmlHandle hdl(&listHuman);
-    TiXmlElement *elem = hdl.FirstChildElement().FirstChildElement().Element();
-
-    std::string name_obj;
-    std::string mesh_r;
-
-    while (elem) //for each element of the xml file
+    meshTable_t::const_iterator it = listHuman.find(name);
+    if (it != listHuman.end()) //if there is a 3d model relative to this human
     {
-        name_obj = elem->Attribute("name");
-        mesh_r = elem->Attribute("mesh_resource");
-        elem = elem->NextSiblingElement();
-
-        if (name_obj.compare(name) == 0) //if there is a 3d model relative to this human
-        {
-            marker.mesh_resource = mesh_r;
-            marker.mesh_use_embedded_materials = true;
-
-            elem = NULL;
+        marker.scale.x = scale * it->second.scale;
+        marker.scale.y = scale * it->second.scale;
+        marker.scale.z = scale * it->second.scale;
+
+        marker.mesh_resource = it->second.meshResource;
+    } else {
+        if (pose.position.z < -0.4) {
+            //human is seating
+            marker.mesh_resource = "package://toaster_visualizer/mesh/toaster_humans/humanSeat.dae"; //using 3d human model
         } else {
-            if (pose.position.z < -0.4) {
-                //human is seating
-                marker.mesh_resource = "package://toaster_visualizer/mesh/toaster_humans/humanSeat.dae"; //using 3d human model
-            } else {
-                marker.mesh_resource = "package://toaster_visualizer/mesh/toaster_humans/human.dae"; //using 3d human model
-            }
-            marker.mesh_use_embedded_materials = true;
+            marker.mesh_resource = "package://toaster_visualizer/mesh/toaster_humans/human.dae"; //using 3d human model
         }
     }
+    marker.mesh_use_embedded_materials = true;
 
-    marker.lifetime = ros::Duration(1.0);
+    marker.lifetime = ros::Duration();
 
     return marker;
 }
 
-visualization_msgs::Marker defineRobot(geometry_msgs::Pose pose, double scale, std::string name, int id, TiXmlDocument& listRobot) {
+visualization_msgs::Marker defineRobot(geometry_msgs::Pose pose, double scale, std::string name, int id, const meshTable_t& listRobot) {
 
     //declaration
     visualization_msgs::Marker marker;
@@ -371,35 +381,25 @@ visualization_msgs::Marker defineRobot(geometry_msgs::Pose pose, double scale, s
     //type of marker
     marker.type = visualization_msgs::Marker::MESH_RESOURCE;
 
-    TiXmlHandle hdl(&listRobot);
-    TiXmlElement *elem = hdl.FirstChildElement().FirstChildElement().Element();
-
-    std::string name_obj;
-    std::string mesh_r;
-
-    while (elem) //for each element of the xml file
+    meshTable_t::const_iterator it = listRobot.find(name);
+    if (it != listRobot.end()) //if there is a 3d model relative to this robot
     {
-        name_obj = elem->Attribute("name");
-        mesh_r = elem->Attribute("mesh_resource");
-        elem = elem->NextSiblingElement();
-
-        if (name_obj.compare(name) == 0) //if there is a 3d model relative to this robot
-        {
-            marker.mesh_resource = mesh_r;
-            marker.mesh_use_embedded_materials = true;
+        marker.scale.x = scale * it->second.scale;
+        marker.scale.y = scale * it->second.scale;
+        marker.scale.z = scale * it->second.scale;
 
-            elem = NULL;
-        } else {
-            marker.mesh_resource = "package://toaster_visualizer/mesh/toaster_robots/pr2.dae"; //using default 3d robot model
-            marker.mesh_use_embedded_materials = true;
-        }
+        marker.mesh_resource = it->second.meshResource;
+    } else {
+        marker.mesh_resource = "package://toaster_visualizer/mesh/toaster_robots/pr2.dae"; //using default 3d robot model
     }
-    marker.lifetime = marker.lifetime = ros::Duration(1.0);
+    marker.mesh_use_embedded_materials = true;
+
+    marker.lifetime = ros::Duration();
 
     return marker;
 }
 
-visualization_msgs::Marker defineArrow(visualization_msgs::Marker& sub, visualization_msgs::Marker& targ, double confidence, bool distance, int id) {
+visualization_msgs::Marker defineArrow(const visualization_msgs::Marker& sub, const visualization_msgs::Marker& targ, double confidence, bool distance, int id) {
 
     //declaration
     visualization_msgs::Marker marker;
@@ -458,7 +458,7 @@ visualization_msgs::Marker defineArrow(visualization_msgs::Marker& sub, visualiz
     marker.type = visualization_msgs::Marker::ARROW;
     marker.mesh_use_embedded_materials = true;
 
-    marker.lifetime = ros::Duration(0.01);
+    marker.lifetime = ros::Duration();
 
     return marker;
 }
@@ -22,8 +22,10 @@
 #include "toaster_msgs/Scale.h"
 
 #include "markerCreator.h"
+#include "markerCache.h"
+
+#include <boost/unordered_map.hpp>
 
-#include <tinyxml.h>
 #include <tf/transform_listener.h>
 
 //nameMarker rpoportionnal scale
@@ -35,11 +37,29 @@ class Run {
     visualization_msgs::MarkerArray robot_list;
     visualization_msgs::MarkerArray arrow_list;
 
+    //markers sent to rviz on each topic, only changes are sent
+    MarkerCache area_cache;
+    MarkerCache obj_cache;
+    MarkerCache human_cache;
+    MarkerCache robot_cache;
+    MarkerCache arrow_cache;
+    visualization_msgs::MarkerArray changes;
+
+    //all markers are sent again at this period, for rviz displays added later
+    ros::Duration refreshPeriod_;
+    ros::Time lastRefresh_;
+
     std::vector<toaster_msgs::Fact> factList;
 
-    //a vector to store allready treated marker's name and an id counter
-    std::vector<std::string> name_list;
+    //a map to store allready treated marker's name with their id and an id counter
+    boost::unordered_map<std::string, int> name_list;
     int id_cpt;
+
+    //position of the markers in their list by namespace, updated with the lists
+    typedef boost::unordered_map<std::string, unsigned int> markerIndex_t;
+    markerIndex_t obj_index;
+    markerIndex_t human_index;
+    markerIndex_t robot_index;
     float objectNameScale_;
     float humanNameScale_;
     float robotNameScale_;
@@ -66,10 +86,11 @@ class Run {
     ros::Publisher pub_robot;
     ros::Publisher pub_movingTwrd;
 
-    TiXmlDocument listObj;
-    TiXmlDocument listHuman;
-    TiXmlDocument listJoint;
-    TiXmlDocument listRobot;
+    //meshes of the xml lists, parsed once
+    MarkerCreator::meshTable_t listObj;
+    MarkerCreator::meshTable_t listHuman;
+    MarkerCreator::meshTable_t listJoint;
+    MarkerCreator::meshTable_t listRobot;
 
 public:
 
@@ -77,7 +98,6 @@ public:
      * Constructor of the run class for toaster_visualizer
      */
     Run(ros::NodeHandle& node) {
-        name_list = std::vector<std::string>();
         id_cpt = 1;
         printNames_ = true;
 
@@ -92,6 +112,21 @@ public:
         robot_list = visualization_msgs::MarkerArray();
         arrow_list = visualization_msgs::MarkerArray();
 
+        //changes under which a marker is not sent again
+        ros::NodeHandle privateNode("~");
+        double refreshPeriod = 5.0;
+        double positionThreshold = 0.001, orientationThreshold = 0.001, colorThreshold = 0.01, scaleThreshold = 0.001;
+        privateNode.getParam("refresh_period", refreshPeriod);
+        privateNode.getParam("position_threshold", positionThreshold);
+        privateNode.getParam("orientation_threshold", orientationThreshold);
+        privateNode.getParam("color_threshold", colorThreshold);
+        privateNode.getParam("scale_threshold", scaleThreshold);
+        refreshPeriod_ = ros::Duration(refreshPeriod);
+
+        MarkerCache* caches[] = {&area_cache, &obj_cache, &human_cache, &robot_cache, &arrow_cache};
+        for (unsigned int i = 0; i < 5; i++)
+            caches[i]->setThresholds(positionThreshold, orientationThreshold, colorThreshold, scaleThreshold);
+
         //definition of subscribers
         sub_objList = node.subscribe("/pdg/objectList", 1000, &Run::chatterCallbackObjList, this);
         sub_areaList = node.subscribe("/area_manager/areaList", 1000, &Run::chatterCallbackAreaList, this);
@@ -119,17 +154,11 @@ public:
         openXmlFile("/src/list_robot.xml", listRobot);
     }
 
-    bool openXmlFile(std::string fileName, TiXmlDocument& doc)
+    bool openXmlFile(std::string fileName, MarkerCreator::meshTable_t& table)
     {
       std::stringstream path;
       path << ros::package::getPath("toaster_visualizer") << fileName;
-      doc = TiXmlDocument(path.str());
-
-      if (!doc.LoadFile()) {
-          ROS_WARN_ONCE("Error while loading xml file");
-          ROS_WARN_ONCE("error # %d", doc.ErrorId());
-          ROS_WARN_ONCE("%s", doc.ErrorDesc());
-      }
+      return MarkerCreator::loadMeshTable(path.str(), table);
     }
 
     bool switchNamePrint(toaster_msgs::Empty::Request &req, toaster_msgs::Empty::Response &res) {
@@ -175,13 +204,37 @@ public:
      * @param name		name of target
      * @return id		new identifier or target's identifier if his name already have been assigned to an identifier
      */
-    int id_generator(std::string name) {
-        if (std::find(name_list.begin(), name_list.end(), name) != name_list.end()) {
-            return std::find(name_list.begin(), name_list.end(), name) - name_list.begin() + 1;
-        } else {
-            name_list.push_back(name);
-            return id_cpt++;
-        }
+    int id_generator(const std::string& name) {
+        std::pair<boost::unordered_map<std::string, int>::iterator, bool> it = name_list.insert(std::make_pair(name, id_cpt));
+        if (it.second)
+            id_cpt++;
+        return it.first->second;
+    }
+
+    /**
+     * Index the markers of a list by namespace, the first marker of a namespace being kept
+     * @param list		list of markers
+     * @param index		index to fill
+     * @return 			void
+     */
+    void indexMarkers(const visualization_msgs::MarkerArray& list, markerIndex_t& index) {
+        index.clear();
+        for (unsigned int i = 0; i < list.markers.size(); i++)
+            index.insert(std::make_pair(list.markers[i].ns, i));
+    }
+
+    /**
+     * Find a marker by namespace
+     * @param name		namespace of the marker
+     * @param list		list of markers
+     * @param index		index of the list
+     * @return marker 	found marker or NULL
+     */
+    const visualization_msgs::Marker* findMarker(const std::string& name, const visualization_msgs::MarkerArray& list, const markerIndex_t& index) {
+        markerIndex_t::const_iterator it = index.find(name);
+        if (it == index.end())
+            return NULL;
+        return &list.markers[it->second];
     }
 
     bool isSeating(const toaster_msgs::Human hum) {
@@ -312,6 +365,8 @@ public:
         p.orientation.w = 1.0;
         visualization_msgs::Marker m = MarkerCreator::defineObj(p, "env", false, id_generator("env"), listObj);
         obj_list.markers.push_back(m);
+
+        indexMarkers(obj_list, obj_index);
     }
 
     /**
@@ -409,6 +464,8 @@ public:
 
             ROS_DEBUG("robot %d", m.id);
         }
+
+        indexMarkers(robot_list, robot_index);
     }
 
     /**
@@ -485,51 +542,37 @@ public:
                     //type of marker
                     markerTempo.type = 3;
 
-                    TiXmlHandle hdl(&listJoint);
-                    TiXmlElement *elem = hdl.FirstChildElement().FirstChildElement().Element();
-
-                    std::string name_obj;
-                    std::string mesh_r;
-
-                    while (elem) //for each element of the xml file
+                    MarkerCreator::meshTable_t::const_iterator itMesh = listJoint.find(name);
+                    if (itMesh != listJoint.end()) //if there is a 3d model related to this object
                     {
-                        name_obj = elem->Attribute("name");
-                        mesh_r = elem->Attribute("mesh_resource");
-                        elem = elem->NextSiblingElement();
-
-                        if (name_obj.compare(name) == 0) //if there is a 3d model related to this object
-                        {
-
+                        markerTempo.scale.x = scale * itMesh->second.scale;
+                        markerTempo.scale.y = scale * itMesh->second.scale;
+                        markerTempo.scale.z = scale * itMesh->second.scale;
 
-                            markerTempo.scale.x = scale;
-                            markerTempo.scale.y = scale;
-                            markerTempo.scale.z = scale;
 
+                        markerTempo.color.r = 0.0;
+                        markerTempo.color.g = 0.0;
+                        markerTempo.color.b = 0.0;
+                        markerTempo.color.a = 0.0;
 
-                            markerTempo.color.r = 0.0;
-                            markerTempo.color.g = 0.0;
-                            markerTempo.color.b = 0.0;
-                            markerTempo.color.a = 0.0;
+                        markerTempo.type = visualization_msgs::Marker::MESH_RESOURCE; //use it as mesh
 
-                            markerTempo.type = visualization_msgs::Marker::MESH_RESOURCE; //use it as mesh
-
-                            if (isSeating(msg->humanList[i]) && name == "base") {
-                                markerTempo.mesh_resource = "package://toaster_visualizer/mesh/toaster_humans/mocapMorse/baseSeat.dae"; //using 3d human model
-                            } else {
-                                markerTempo.mesh_resource = mesh_r;
-                            }
-                            markerTempo.mesh_use_embedded_materials = true;
-
-                            elem = NULL;
+                        if (isSeating(msg->humanList[i]) && name == "base") {
+                            markerTempo.mesh_resource = "package://toaster_visualizer/mesh/toaster_humans/mocapMorse/baseSeat.dae"; //using 3d human model
+                        } else {
+                            markerTempo.mesh_resource = itMesh->second.meshResource;
                         }
+                        markerTempo.mesh_use_embedded_materials = true;
                     }
 
-                    markerTempo.lifetime = ros::Duration(1.0);
+                    markerTempo.lifetime = ros::Duration();
 
                     human_list.markers.push_back(markerTempo);
                 }
             }
         }
+
+        indexMarkers(human_list, human_index);
     }
 
     void chatterCallbackFactList(const toaster_msgs::FactList::ConstPtr& msg)
@@ -550,122 +593,64 @@ public:
                 agentMoving_map[msg->factList[iFact].subjectId] = msg->factList[iFact].confidence;
             else if (msg->factList[iFact].property == "IsMovingToward") {
 
-                bool foundSub = false;
-                bool foundTarg = false;
-                visualization_msgs::Marker sub;
-                visualization_msgs::Marker targ;
-                visualization_msgs::Marker arrow;
-
-                //Let's look for the subject position:
-                for (unsigned int i = 0; i < human_list.markers.size(); i++) {
-                    if (human_list.markers[i].ns.compare(msg->factList[iFact].subjectId) == 0) {
-                        sub = human_list.markers[i];
-                        foundSub = true;
-                        break;
-                    }
-                }
-
-                if (foundSub) {
-                    for (unsigned int i = 0; i < human_list.markers.size(); i++) {
-
-                        if (human_list.markers[i].ns.compare(msg->factList[iFact].targetId) == 0) {
-
-                            targ = human_list.markers[i];
-                            foundTarg = true;
-                            break;
-                        }
-                    }
-
-                    if (!foundTarg) {
-                        for (unsigned int i = 0; i < robot_list.markers.size(); i++) {
-                            if (robot_list.markers[i].ns.compare(msg->factList[iFact].targetId) == 0) {
-                                targ = robot_list.markers[i];
-                                foundTarg = true;
-                                break;
-                            }
-                        }
-                        if (!foundTarg) {
-                            for (unsigned int i = 0; i < obj_list.markers.size(); i++) {
-                                if (obj_list.markers[i].ns.compare(msg->factList[iFact].targetId) == 0) {
-                                    targ = obj_list.markers[i];
-                                    foundTarg = true;
-                                    break;
-                                }
-                            }
-                            if (!foundTarg) {
-                                continue;
-                            }
-                        }
-                    }
-
-
-                } else {
-                    for (unsigned int i = 0; i < robot_list.markers.size(); i++) {
-                        if (robot_list.markers[i].ns.compare(msg->factList[iFact].subjectId) == 0) {
-                            sub = human_list.markers[i];
-                            foundSub = true;
-                            break;
-                        }
-                    }
-
-                    if (foundSub) {
-                        for (unsigned int i = 0; i < human_list.markers.size(); i++) {
-                            if (human_list.markers[i].ns.compare(msg->factList[iFact].targetId) == 0) {
-                                targ = human_list.markers[i];
-                                foundTarg = true;
-                                break;
-                            }
-                        }
-                        if (!foundTarg) {
-                            for (unsigned int i = 0; i < robot_list.markers.size(); i++) {
-                                if (robot_list.markers[i].ns.compare(msg->factList[iFact].targetId) == 0) {
-                                    targ = robot_list.markers[i];
-                                    foundTarg = true;
-                                    break;
-                                }
-                            }
-                            if (!foundTarg) {
-                                for (unsigned int i = 0; i < obj_list.markers.size(); i++) {
-                                    if (obj_list.markers[i].ns.compare(msg->factList[iFact].targetId) == 0) {
-                                        targ = human_list.markers[i];
-                                        foundTarg = true;
-                                        break;
-                                    }
-                                }
-                                if (!foundTarg) {
-                                    continue;
-                                }
-                            }
-                        }
-                    }
-                }
+                //Let's look for the subject and target positions:
+                const visualization_msgs::Marker* sub = findMarker(msg->factList[iFact].subjectId, human_list, human_index);
+                if (sub == NULL)
+                    sub = findMarker(msg->factList[iFact].subjectId, robot_list, robot_index);
+                if (sub == NULL)
+                    continue;
+
+                const visualization_msgs::Marker* targ = findMarker(msg->factList[iFact].targetId, human_list, human_index);
+                if (targ == NULL)
+                    targ = findMarker(msg->factList[iFact].targetId, robot_list, robot_index);
+                if (targ == NULL)
+                    targ = findMarker(msg->factList[iFact].targetId, obj_list, obj_index);
+                if (targ == NULL)
+                    continue;
 
                 // Create arrow
-                if (foundTarg && foundSub) {
-                  bool distance = msg->factList[iFact].subProperty.compare("distance") == 0;
-                  std::ostringstream nameSpace;
-                  std::string subtype = "distance";
-                  if (!distance)
-                      subtype = "direction";
-                  nameSpace << sub.ns << " MvTwd " << subtype << targ.ns;
-                  arrow = MarkerCreator::defineArrow(sub, targ, msg->factList[iFact].confidence,
-                                                    distance, id_generator(nameSpace.str()));
-                  arrow_list.markers.push_back(arrow);
-                }
+                bool distance = msg->factList[iFact].subProperty.compare("distance") == 0;
+                std::ostringstream nameSpace;
+                std::string subtype = "distance";
+                if (!distance)
+                    subtype = "direction";
+                nameSpace << sub->ns << " MvTwd " << subtype << targ->ns;
+                visualization_msgs::Marker arrow = MarkerCreator::defineArrow(*sub, *targ, msg->factList[iFact].confidence,
+                                                                              distance, id_generator(nameSpace.str()));
+                arrow_list.markers.push_back(arrow);
             }
         }
     }
 
+    /**
+     * Function sending the changes of a marker list to rviz
+     * @param pub			publisher of the list
+     * @param cache		markers already sent by pub
+     * @param list			markers to show
+     * @param refresh		if true, all markers are sent
+     * @return 			void
+     */
+    void sendChanges(ros::Publisher& pub, MarkerCache& cache, const visualization_msgs::MarkerArray& list, bool refresh) {
+        cache.update(list, changes, refresh);
+        if (!changes.markers.empty())
+            pub.publish(changes);
+    }
+
     /**
      * Function sending all marker list to rviz
      * @return 			void
      */
     void send() {
-        pub_area.publish(area_list);
-        pub_obj.publish(obj_list);
-        pub_human.publish(human_list);
-        pub_robot.publish(robot_list);
-        pub_movingTwrd.publish(arrow_list);
+        ros::Time now = ros::Time::now();
+        bool refresh = refreshPeriod_ > ros::Duration() && now - lastRefresh_ >= refreshPeriod_;
+        if (refresh)
+            lastRefresh_ = now;
+
+        sendChanges(pub_area, area_cache, area_list, refresh);
+        sendChanges(pub_obj, obj_cache, obj_list, refresh);
+        sendChanges(pub_human, human_cache, human_list, refresh);
+        sendChanges(pub_robot, robot_cache, robot_list, refresh);
+        sendChanges(pub_movingTwrd, arrow_cache, arrow_list, refresh);
 
         ros::spinOnce();
     }